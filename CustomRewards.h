@@ -4,7 +4,7 @@
 
 using namespace RLGSC;
 
-class SpeedTowardBallReward : public RewardFunction {
+class SpeedTowardBallReward : public PlayerRewardFunction<SpeedTowardBallReward> {
 public:
     // Constructor
     SpeedTowardBallReward() = default;
@@ -13,7 +13,8 @@ public:
     virtual void Reset(const GameState& initialState) override {}
 
     // Get the reward for a specific player, at the current state
-    virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) override {
+    // PlayerRewardFunction calls this for every player at once
+    float Eval(const PlayerData& player, const GameState& state) const {
         // Velocity of our player
         Vec playerVel = player.phys.vel;
 
@@ -14,21 +14,74 @@ rlbot::Bot* BotFactory(int index, int team, std::string name) {
 	return new RLBotBot(index, team, name, g_RLBotParams);
 }
 
+InferUnit* CreatePolicyInferUnit(const RLBotParams& params) {
+	RG_LOG(" > Loading policy from " << params.policyPath << "...");
+	InferUnit* inferUnit = new InferUnit(
+		params.obsBuilder, params.actionParser, params.policyPath, true, params.obsSize, params.policyLayerSizes, false
+	);
+
+	if (!params.obsStatsPath.empty()) {
+		RG_LOG(" > Loading observation stats from " << params.obsStatsPath << "...");
+		inferUnit->LoadOBSStats(params.obsStatsPath, params.obsClipRange);
+	}
+
+	return inferUnit;
+}
+
+// Shared by all bots when batching inference, created by the first bot and deleted with the last
+std::mutex g_SharedInferMutex = {};
+InferUnit* g_SharedInferUnit = NULL;
+InferBatcher* g_SharedInferBatcher = NULL;
+int g_SharedInferBots = 0;
+
 RLBotBot::RLBotBot(int _index, int _team, std::string _name, const RLBotParams& params) 
 	: rlbot::Bot(_index, _team, _name), params(params) {
 
 	RG_LOG("Creating RLBot bot: index " << _index << ", name: " << name << "...");
 
-	RG_LOG(" > Loading policy from " << params.policyPath << "...");
-	policyInferUnit = new InferUnit(
-		params.obsBuilder, params.actionParser, params.policyPath, true, params.obsSize, params.policyLayerSizes, false
-	);
+	if (params.batchInference) {
+		std::lock_guard<std::mutex> lock(g_SharedInferMutex);
+		if (!g_SharedInferUnit) {
+			g_SharedInferUnit = CreatePolicyInferUnit(params);
+			g_SharedInferBatcher = new InferBatcher(g_SharedInferUnit, params.inferBatchWindow, true);
+			g_SharedInferBatcher->logLatency = params.logInferLatency;
+		}
+
+		g_SharedInferBots++;
+		policyInferUnit = g_SharedInferUnit;
+		inferBatcher = g_SharedInferBatcher;
+		inferBatcher->AddClient();
+	} else {
+		policyInferUnit = CreatePolicyInferUnit(params);
+	}
+
+	if (params.inferOnThread)
+		inferThread = std::thread(&RLBotBot::RunInferThread, this);
 
 	RG_LOG(" > Done!");
 }
 
 RLBotBot::~RLBotBot() {
-	delete policyInferUnit;
+	if (inferThread.joinable()) {
+		stopInfer = true;
+		inferInputs.Publish(); // Wake the thread, it won't infer the input since it is stopping
+		inferThread.join();
+	}
+
+	if (inferBatcher) {
+		inferBatcher->RemoveClient();
+
+		std::lock_guard<std::mutex> lock(g_SharedInferMutex);
+		g_SharedInferBots--;
+		if (g_SharedInferBots == 0) {
+			delete g_SharedInferBatcher;
+			delete g_SharedInferUnit;
+			g_SharedInferBatcher = NULL;
+			g_SharedInferUnit = NULL;
+		}
+	} else {
+		delete policyInferUnit;
+	}
 }
 
 Vec ToVec(const rlbot::flat::Vector3* rlbotVec) {
@@ -48,14 +101,14 @@ PhysObj ToPhysObj(const rlbot::flat::Physics* phys) {
 	return obj;
 }
 
-PlayerData ToPlayer(const rlbot::flat::PlayerInfo* playerInfo) {
-	PlayerData pd = {};
+// Writes into an existing player, so the state's player list can be re-used
+void ToPlayer(const rlbot::flat::PlayerInfo* playerInfo, PlayerData& pd) {
+	pd = {};
 	pd.carId = playerInfo->spawnId();
 
 	pd.team = (Team)playerInfo->team();
 
 	pd.phys = ToPhysObj(playerInfo->physics());
-	pd.physInv = pd.phys.Invert();
 
 	pd.carState.pos = pd.phys.pos;
 	pd.carState.rotMat = pd.phys.rotMat;
@@ -68,19 +121,18 @@ PlayerData ToPlayer(const rlbot::flat::PlayerInfo* playerInfo) {
 	pd.carState.hasDoubleJumped = playerInfo->doubleJumped();
 	pd.carState.isDemoed = playerInfo->isDemolished();
 	pd.hasFlip = !playerInfo->doubleJumped();
-
-	return pd;
 }
 
-GameState ToGameState(rlbot::GameTickPacket& gameTickPacket) {
-	GameState gs = {};
-
+// Updates an existing state, so it doesn't allocate once the player list has grown to size
+void ToGameState(rlbot::GameTickPacket& gameTickPacket, GameState& gs) {
 	auto players = gameTickPacket->players();
+	gs.players.resize(players->size());
 	for (int i = 0; i < players->size(); i++)
-		gs.players.push_back(ToPlayer(players->Get(i)));
+		ToPlayer(players->Get(i), gs.players[i]);
 
 	gs.ball = ToPhysObj(gameTickPacket->ball()->physics());
-	gs.ballInv = gs.ball.Invert();
+	gs._ballInvValid = false;
+	gs._boostPadsInvValid = false;
 
 	auto boostPadStates = gameTickPacket->boostPadStates();
 	if (boostPadStates->size() != CommonValues::BOOST_LOCATIONS_AMOUNT) {
@@ -93,16 +145,36 @@ GameState ToGameState(rlbot::GameTickPacket& gameTickPacket) {
 		// Just set all boost pads to on
 		std::fill(gs.boostPads.begin(), gs.boostPads.end(), 1);
 	} else {
-		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
+		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++)
 			gs.boostPads[i] = boostPadStates->Get(i)->isActive();
-			gs.boostPadsInv[CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1] = gs.boostPads[i];
-		}
 	}
+}
+
+Action RLBotBot::InferAction(const GameState& state, const Action& prevControls) {
+	auto& localPlayer = state.players[index];
+	if (inferBatcher) {
+		return inferBatcher->InferPolicy(localPlayer, state, prevControls);
+	} else {
+		return policyInferUnit->InferPolicySingle(localPlayer, state, prevControls, true);
+	}
+}
 
-	return gs;
+void RLBotBot::RunInferThread() {
+	while (true) {
+		// Sleeps until GetOutput() publishes a new state (or the destructor wakes us up to stop)
+		inferInputs.WaitForNew();
+		if (stopInfer)
+			break;
+
+		inferInputs.Update();
+		auto& input = inferInputs.Front();
+		inferOutputs.Back() = InferAction(input.state, input.prevControls);
+		inferOutputs.Publish();
+	}
 }
 
 rlbot::Controller RLBotBot::GetOutput(rlbot::GameTickPacket gameTickPacket) {
+	Timer tickTimer = {};
 
 	float curTime = gameTickPacket->gameInfo()->secondsElapsed();
 	float deltaTime = curTime - prevTime;
@@ -111,12 +183,22 @@ rlbot::Controller RLBotBot::GetOutput(rlbot::GameTickPacket gameTickPacket) {
 	int ticksElapsed = roundf(deltaTime * 120);
 	ticks += ticksElapsed;
 
-	GameState gs = ToGameState(gameTickPacket);
-	auto& localPlayer = gs.players[index];
-
-	if (updateAction) {
+	if (inferThread.joinable()) {
+		// Use whatever the latest action is
+		if (inferOutputs.Update())
+			action = inferOutputs.Front();
+
+		if (updateAction) {
+			updateAction = false;
+			auto& input = inferInputs.Back();
+			ToGameState(gameTickPacket, input.state);
+			input.prevControls = controls;
+			inferInputs.Publish();
+		}
+	} else if (updateAction) {
 		updateAction = false;
-		action = policyInferUnit->InferPolicySingle(localPlayer, gs, controls, true);
+		ToGameState(gameTickPacket, gameState);
+		action = InferAction(gameState, controls);
 	}
 
 	if (ticks >= params.tickSkip || ticks == -1) {
@@ -142,6 +224,15 @@ rlbot::Controller RLBotBot::GetOutput(rlbot::GameTickPacket gameTickPacket) {
 		rc.handbrake = controls.handbrake;
 	}
 
+	tickLatency.Add(tickTimer.Elapsed());
+	if (params.latencyReportTicks > 0 && tickLatency.count >= params.latencyReportTicks) {
+		RG_LOG(
+			"RLBotBot " << index << ": Tick latency (ms) p50: " << (tickLatency.GetPercentile(0.5) * 1000) <<
+			", p99: " << (tickLatency.GetPercentile(0.99) * 1000) << ", max: " << (tickLatency.max * 1000)
+		);
+		tickLatency.Reset();
+	}
+
 	return rc;
 }
 
@@ -5,6 +5,11 @@
 #include <RLGymSim_CPP/Utils/ActionParsers/ActionParser.h>
 
 #include <RLGymPPO_CPP/Util/InferUnit.h>
+#include <RLGymPPO_CPP/Util/InferBatcher.h>
+#include <RLGymPPO_CPP/Util/LatencyHistogram.h>
+
+#include <thread>
+#include <atomic>
 
 struct RLBotParams {
 	// Set this to the same port used in rlbot/port.cfg
@@ -17,6 +22,64 @@ struct RLBotParams {
 	int obsSize; // You can find this from the console when running training
 	std::vector<int> policyLayerSizes = {}; // Your layer sizes
 	int tickSkip; // Your tick skip
+
+	// If you trained with standardizeOBS, set this to the RUNNING_STATS.json from the same checkpoint as your policy
+	std::filesystem::path obsStatsPath = {};
+	float obsClipRange = 5; // Must match LearnerConfig::obsClipRange
+
+	// If true, all bots run by this process share one policy, and their inference is batched into one forward per tick
+	bool batchInference = true;
+	float inferBatchWindow = 0.002f; // Max time (in seconds) a bot waits for the other bots to join its batch
+	bool logInferLatency = false; // Periodically log latency percentiles of batched inference
+
+	// Runs inference on a dedicated thread for each bot, so GetOutput() only hands off the state and returns the latest action
+	// If inference takes longer than the tick skip, the previous action is kept instead of stalling the tick
+	bool inferOnThread = false;
+
+	int latencyReportTicks = 0; // Log the p50/p99/max latency of GetOutput() every this many ticks, 0 to disable
+};
+
+// Lock-free single producer, single consumer handoff of the latest value
+// The producer writes to Back() then calls Publish(), the consumer calls Update() then reads Front()
+// The consumer can block on WaitForNew() until there is something to update to
+template <typename T>
+struct TripleBuffer {
+	static constexpr uint8_t INDEX_MASK = 0b11, NEW_BIT = 0b100;
+
+	T slots[3] = {};
+	std::atomic<uint8_t> _middle = 1; // Index of the middle slot, with NEW_BIT set if it hasn't been read
+	uint8_t _back = 0, _front = 2;
+
+	T& Back() {
+		return slots[_back];
+	}
+
+	void Publish() {
+		_back = _middle.exchange(_back | NEW_BIT) & INDEX_MASK;
+		_middle.notify_one();
+	}
+
+	// Blocks until a value is published that Update() hasn't taken yet
+	void WaitForNew() const {
+		uint8_t middle = _middle.load();
+		while (!(middle & NEW_BIT)) {
+			_middle.wait(middle);
+			middle = _middle.load();
+		}
+	}
+
+	// Returns true if a new value was published since the last update
+	bool Update() {
+		if (!(_middle.load() & NEW_BIT))
+			return false;
+
+		_front = _middle.exchange(_front) & INDEX_MASK;
+		return true;
+	}
+
+	const T& Front() const {
+		return slots[_front];
+	}
 };
 
 class RLBotBot : public rlbot::Bot {
@@ -26,8 +89,12 @@ public:
 	RLBotParams params;
 
 	// Inference unit to infer the policy with, also uses our obs and action parser
+	// Shared by all bots if params.batchInference is set
 	RLGPC::InferUnit* policyInferUnit;
 
+	// Batches our inference with the other bots in this process, NULL if params.batchInference is not set
+	RLGPC::InferBatcher* inferBatcher = NULL;
+
 	// Queued action and current action
 	RLGSC::Action 
 		action = {}, 
@@ -38,10 +105,28 @@ public:
 	float prevTime = 0;
 	int ticks = -1;
 
+	// Re-used every tick, so nothing needs to be allocated once it has grown to size
+	RLGSC::GameState gameState = {};
+
+	// Used if params.inferOnThread is set
+	struct InferInput {
+		RLGSC::GameState state;
+		RLGSC::Action prevControls;
+	};
+	std::thread inferThread;
+	std::atomic<bool> stopInfer = false;
+	TripleBuffer<InferInput> inferInputs;
+	TripleBuffer<RLGSC::Action> inferOutputs;
+
+	RLGPC::LatencyHistogram tickLatency;
+
 	RLBotBot(int _index, int _team, std::string _name, const RLBotParams& params);
 	~RLBotBot();
 
 	rlbot::Controller GetOutput(rlbot::GameTickPacket gameTickPacket) override;
+
+	RLGSC::Action InferAction(const RLGSC::GameState& state, const RLGSC::Action& prevControls);
+	void RunInferThread();
 };
 
 namespace RLBotClient {
@@ -1,5 +1,7 @@
 #include "RocketSim.h"
 
+#include "Sim/MeshTriangleGrid/MeshTriangleGrid.h"
+
 #include "../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
 #include "../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btTriangleMesh.h"
 #include "../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btInternalEdgeUtility.h"
@@ -168,6 +170,14 @@ void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& mes
 				btTriangleInfoMap* infoMap = new btTriangleInfoMap();
 				btGenerateInternalEdgeInfo(bvtMesh, infoMap);
 				bvtMesh->setTriangleInfoMap(infoMap);
+
+#ifndef RS_NO_MESHTRIGRID
+				// Arenas copy the shape, so they all get the same grid through the user pointer
+				MeshTriangleGrid* triGrid = new MeshTriangleGrid();
+				triGrid->Build(bvtMesh);
+				bvtMesh->setUserPointer(triGrid);
+#endif
+
 				meshes.push_back(bvtMesh);
 
 				idx++;
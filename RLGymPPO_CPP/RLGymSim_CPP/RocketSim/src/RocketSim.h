@@ -2,6 +2,7 @@
 #include "Sim/Car/Car.h"
 #include "Sim/Ball/Ball.h"
 #include "Sim/Arena/Arena.h"
+#include "Sim/Arena/ArenaFactory/ArenaFactory.h"
 
 #include "Math/Math.h"
 
@@ -9,6 +10,7 @@
 //	RS_MAX_SPEED: Define this to remove certain sanity checks for faster speed
 //	RS_DONT_LOG: Define this to disable all logging output
 //	RS_NO_SUSPCOLGRID: Disable the suspension-collision grid optimization
+//	RS_NO_MESHTRIGRID: Disable the arena mesh triangle grids used for suspension raycasts
 //	RS_NO_NAMESPACE: Disable the RocketSim namespace encapsulating all RocketSim classes/structs
 
 class btBvhTriangleMeshShape;
@@ -1,4 +1,5 @@
 #include "Arena.h"
+#include "ArenaFactory/ArenaFactory.h"
 #include "../../RocketSim.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btAxisSweep3.h"
@@ -65,10 +66,10 @@ bool Arena::_AddCarFromPtr(Car* car) {
 	car->id = ++_lastCarID;
 
 	if (_carIDMap.find(car->id) == _carIDMap.end()) {
-		assert(!_cars.count(car));
+		assert(std::find(_cars.begin(), _cars.end(), car) == _cars.end());
 		
 		_carIDMap[car->id] = car;
-		_cars.insert(car);
+		_cars.push_back(car);
 		return true;
 
 	} else {
@@ -82,7 +83,7 @@ bool Arena::RemoveCar(uint32_t id) {
 	if (itr != _carIDMap.end()) {
 		Car* car = itr->second;
 		_carIDMap.erase(itr);
-		_cars.erase(car);
+		_cars.erase(std::find(_cars.begin(), _cars.end(), car));
 		_bulletWorld.removeCollisionObject(&car->_rigidBody);
 		if (ownsCars)
 			delete car;
@@ -426,7 +427,7 @@ void Arena::_BtCallback_OnCarWorldCollision(Car* car, btCollisionObject* world,
 	manifoldPoint.m_combinedRestitution = _mutatorConfig.carWorldRestitution;
 }
 
-Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mutatorConfig(gameMode), _config(config), _suspColGrid(gameMode) {
+Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate, ArenaFactory* factory) : _mutatorConfig(gameMode), _config(config), _suspColGrid(gameMode) {
 
 	// Tickrate must be from 15 to 120tps
 	assert(tickRate >= 15 && tickRate <= 120);
@@ -441,7 +442,10 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 		btDefaultCollisionConstructionInfo collisionConfigConstructionInfo = {};
 
 		// These take up a ton of memory normally
-		if (_config.memWeightMode == ArenaMemWeightMode::LIGHT) {
+		if (factory) {
+			collisionConfigConstructionInfo.m_persistentManifoldPool = factory->_persistentManifoldPool;
+			collisionConfigConstructionInfo.m_collisionAlgorithmPool = factory->_collisionAlgorithmPool;
+		} else if (_config.memWeightMode == ArenaMemWeightMode::LIGHT) {
 			collisionConfigConstructionInfo.m_defaultMaxPersistentManifoldPoolSize /= 32;
 			collisionConfigConstructionInfo.m_defaultMaxCollisionAlgorithmPoolSize /= 64;
 		} else {
@@ -566,6 +570,10 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 }
 
 Arena* Arena::Create(GameMode gameMode, const ArenaConfig& arenaConfig, float tickRate) {
+	ArenaFactory* scopedFactory = ArenaFactory::_GetScopedFactory();
+	if (scopedFactory)
+		return scopedFactory->Create(gameMode, arenaConfig, tickRate);
+
 	return new Arena(gameMode, arenaConfig, tickRate);
 }
 
@@ -700,6 +708,68 @@ Arena* Arena::Clone(bool copyCallbacks) {
 	return newArena;
 }
 
+void Arena::SaveSnapshot(ArenaSnapshot& out) const {
+	out.tickCount = tickCount;
+
+	out.ball.state = ball->_internalState;
+	out.ball.velocityImpulseCache = ball->_velocityImpulseCache;
+	out.ball.groundStickApplied = ball->_groundStickApplied;
+	out.ball.rigidBody.Save(ball->_rigidBody);
+
+	out.cars.resize(_cars.size());
+	size_t carIndex = 0;
+	for (Car* car : _cars) {
+		CarSnapshot& carSnapshot = out.cars[carIndex++];
+		carSnapshot.id = car->id;
+		carSnapshot.state = car->_internalState;
+		carSnapshot.controls = car->controls;
+		carSnapshot.velocityImpulseCache = car->_velocityImpulseCache;
+		carSnapshot.rigidBody.Save(car->_rigidBody);
+		for (int i = 0; i < 4; i++)
+			carSnapshot.wheels[i] = car->_bulletVehicle.m_wheelInfo[i];
+	}
+
+	out.boostPads.resize(_boostPads.size());
+	for (size_t i = 0; i < _boostPads.size(); i++)
+		out.boostPads[i] = _boostPads[i]->_internalState;
+}
+
+void Arena::RestoreSnapshot(const ArenaSnapshot& snapshot) {
+	constexpr const char* ERROR_PREFIX = "Arena::RestoreSnapshot(): ";
+
+	if (snapshot.cars.size() != _cars.size())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot has " << snapshot.cars.size() << " cars, but the arena has " << _cars.size());
+
+	if (snapshot.boostPads.size() != _boostPads.size())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot has " << snapshot.boostPads.size() << " boost pads, but the arena has " << _boostPads.size());
+
+	tickCount = snapshot.tickCount;
+
+	ball->_internalState = snapshot.ball.state;
+	ball->_internalState.updateCounter = 0;
+	ball->_velocityImpulseCache = snapshot.ball.velocityImpulseCache;
+	ball->_groundStickApplied = snapshot.ball.groundStickApplied;
+	snapshot.ball.rigidBody.Restore(ball->_rigidBody);
+
+	for (const CarSnapshot& carSnapshot : snapshot.cars) {
+		auto itr = _carIDMap.find(carSnapshot.id);
+		if (itr == _carIDMap.end())
+			RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot has a car with ID " << carSnapshot.id << ", which is not in the arena");
+
+		Car* car = itr->second;
+		car->_internalState = carSnapshot.state;
+		car->_internalState.updateCounter = 0;
+		car->controls = carSnapshot.controls;
+		car->_velocityImpulseCache = carSnapshot.velocityImpulseCache;
+		carSnapshot.rigidBody.Restore(car->_rigidBody);
+		for (int i = 0; i < 4; i++)
+			car->_bulletVehicle.m_wheelInfo[i] = carSnapshot.wheels[i];
+	}
+
+	for (size_t i = 0; i < _boostPads.size(); i++)
+		_boostPads[i]->_internalState = snapshot.boostPads[i];
+}
+
 Car* Arena::DeserializeNewCar(DataStreamIn& in, Team team) {
 	Car* car = Car::_AllocateCar();
 	car->_Deserialize(in);
@@ -10,6 +10,7 @@
 #include "../SuspensionCollisionGrid/SuspensionCollisionGrid.h"
 #include "../MutatorConfig/MutatorConfig.h"
 #include "ArenaConfig/ArenaConfig.h"
+#include "ArenaSnapshot/ArenaSnapshot.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btStaticPlaneShape.h"
@@ -32,7 +33,8 @@ public:
 	GameMode gameMode;
 
 	uint32_t _lastCarID = 0;
-	std::unordered_set<Car*> _cars;
+	// In the order they were added, so iterating over cars is the same on every run
+	std::vector<Car*> _cars;
 	bool ownsCars = true; // If true, deleting this arena instance deletes all cars
 
 	std::unordered_map<uint32_t, Car*> _carIDMap;
@@ -63,7 +65,7 @@ public:
 	// Total ticks this arena instance has been simulated for, never resets
 	uint64_t tickCount = 0;
 
-	const std::unordered_set<Car*>& GetCars() { return _cars; }
+	const std::vector<Car*>& GetCars() { return _cars; }
 	const std::vector<BoostPad*>& GetBoostPads() { return _boostPads; }
 
 	// Returns true if added, false if car was already added
@@ -108,6 +110,7 @@ public:
 	RSAPI void SetCarBumpCallback(CarBumpEventFn callbackFn, void* userInfo = NULL);
 
 	// NOTE: Arena should be destroyed after use
+	// NOTE: If an ArenaFactory::Scope exists on this thread, the arena is created by that factory
 	RSAPI static Arena* Create(GameMode gameMode, const ArenaConfig& arenaConfig = {}, float tickRate = 120);
 	
 	// Serialize entire arena state including cars, ball, and boostpads
@@ -125,6 +128,13 @@ public:
 	// Get a deep copy of the arena
 	RSAPI Arena* Clone(bool copyCallbacks);
 
+	// Save the current state of the arena into a snapshot (re-uses the snapshot's memory)
+	RSAPI void SaveSnapshot(ArenaSnapshot& out) const;
+
+	// Return to the state of a snapshot previously saved from this arena
+	// The arena must have the same cars as when the snapshot was saved
+	RSAPI void RestoreSnapshot(const ArenaSnapshot& snapshot);
+
 	// NOTE: Car ID will not be restored
 	RSAPI Car* DeserializeNewCar(DataStreamIn& in, Team team);
 
@@ -192,8 +202,10 @@ public:
 
 private:
 	
-	// Constructor for use by Arena::Create()
-	Arena(GameMode gameMode, const ArenaConfig& config, float tickRate = 120);
+	// Constructor for use by Arena::Create() and ArenaFactory::Create()
+	// If a factory is provided, its memory pools are used instead of making new ones
+	Arena(GameMode gameMode, const ArenaConfig& config, float tickRate = 120, class ArenaFactory* factory = NULL);
+	friend class ArenaFactory;
 
 	// Making this private because horrible memory overflows can happen if you changed it
 	ArenaConfig _config;
@@ -0,0 +1,50 @@
+#include "ArenaFactory.h"
+
+#include "../../../../libsrc/bullet3-3.24/LinearMath/btPoolAllocator.h"
+
+RS_NS_START
+
+static thread_local ArenaFactory* _scopedFactory = NULL;
+
+ArenaFactory::ArenaFactory(int expectedArenaAmount) {
+	expectedArenaAmount = RS_MAX(expectedArenaAmount, 1);
+
+	int collisionAlgorithmSize;
+	{
+		// The element size of the collision algorithm pool is calculated internally by Bullet, so get it from a minimal config
+		btDefaultCollisionConstructionInfo constructionInfo = {};
+		constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 1;
+		constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 1;
+
+		btDefaultCollisionConfiguration sizingConfig;
+		sizingConfig.setup(constructionInfo);
+		collisionAlgorithmSize = sizingConfig.getCollisionAlgorithmPool()->getElementSize();
+	}
+
+	_persistentManifoldPool = new btPoolAllocator(sizeof(btPersistentManifold), expectedArenaAmount * MANIFOLDS_PER_ARENA);
+	_collisionAlgorithmPool = new btPoolAllocator(collisionAlgorithmSize, expectedArenaAmount * COLLISION_ALGORITHMS_PER_ARENA);
+}
+
+ArenaFactory::~ArenaFactory() {
+	delete _persistentManifoldPool;
+	delete _collisionAlgorithmPool;
+}
+
+Arena* ArenaFactory::Create(GameMode gameMode, const ArenaConfig& arenaConfig, float tickRate) {
+	return new Arena(gameMode, arenaConfig, tickRate, this);
+}
+
+ArenaFactory::Scope::Scope(ArenaFactory* factory) {
+	prevFactory = _scopedFactory;
+	_scopedFactory = factory;
+}
+
+ArenaFactory::Scope::~Scope() {
+	_scopedFactory = prevFactory;
+}
+
+ArenaFactory* ArenaFactory::_GetScopedFactory() {
+	return _scopedFactory;
+}
+
+RS_NS_END
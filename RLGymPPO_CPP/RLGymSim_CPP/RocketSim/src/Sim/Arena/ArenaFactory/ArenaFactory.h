@@ -0,0 +1,48 @@
+#pragma once
+#include "../Arena.h"
+
+class btPoolAllocator;
+
+RS_NS_START
+
+// Creates arenas that share one set of Bullet memory pools (contact manifolds and collision algorithms),
+//	instead of every arena allocating its own large pools up-front
+// Bullet's pools are not thread-safe, so arenas from the same factory must never be stepped at the same time
+// NOTE: The factory must outlive all of the arenas it created
+class ArenaFactory {
+public:
+	// Pool entries reserved per expected arena
+	// If the pools run out, Bullet falls back to normal allocations, so these don't need to be worst-case amounts
+	constexpr static int
+		MANIFOLDS_PER_ARENA = 32,
+		COLLISION_ALGORITHMS_PER_ARENA = 64;
+
+	btPoolAllocator* _persistentManifoldPool;
+	btPoolAllocator* _collisionAlgorithmPool;
+
+	RSAPI ArenaFactory(int expectedArenaAmount);
+	RSAPI ~ArenaFactory();
+
+	ArenaFactory(const ArenaFactory& other) = delete;
+	ArenaFactory& operator=(const ArenaFactory& other) = delete;
+
+	// NOTE: Arena should be destroyed after use, and before the factory
+	RSAPI Arena* Create(GameMode gameMode, const ArenaConfig& arenaConfig = {}, float tickRate = 120);
+
+	// While a scope exists, Arena::Create() on the current thread will go through this factory
+	// Useful when arenas are created by code you don't control (e.g. a Gym made by an env create function)
+	struct Scope {
+		ArenaFactory* prevFactory;
+
+		RSAPI Scope(ArenaFactory* factory);
+		RSAPI ~Scope();
+
+		Scope(const Scope& other) = delete;
+		Scope& operator=(const Scope& other) = delete;
+	};
+
+	// Returns the factory of the innermost scope on the current thread, or NULL if there isn't one
+	static ArenaFactory* _GetScopedFactory();
+};
+
+RS_NS_END
@@ -0,0 +1,26 @@
+#include "ArenaSnapshot.h"
+
+RS_NS_START
+
+void RigidBodySnapshot::Save(const btRigidBody& rb) {
+	worldTransform = rb.getWorldTransform();
+	linearVelocity = rb.m_linearVelocity;
+	angularVelocity = rb.m_angularVelocity;
+	activationState = rb.m_activationState1;
+	collisionFlags = rb.m_collisionFlags;
+	deactivationTime = rb.getDeactivationTime();
+}
+
+void RigidBodySnapshot::Restore(btRigidBody& rb) const {
+	rb.setWorldTransform(worldTransform);
+	rb.setInterpolationWorldTransform(worldTransform);
+	rb.m_linearVelocity = linearVelocity;
+	rb.m_angularVelocity = angularVelocity;
+	rb.m_activationState1 = activationState;
+	rb.m_collisionFlags = collisionFlags;
+	rb.setDeactivationTime(deactivationTime);
+	rb.clearForces();
+	rb.updateInertiaTensor();
+}
+
+RS_NS_END
@@ -0,0 +1,45 @@
+#pragma once
+#include "../../Car/Car.h"
+#include "../../Ball/Ball.h"
+#include "../../BoostPad/BoostPad.h"
+
+RS_NS_START
+
+// Parts of a btRigidBody that change during simulation
+struct RigidBodySnapshot {
+	btTransform worldTransform;
+	btVector3 linearVelocity, angularVelocity;
+	int activationState, collisionFlags;
+	float deactivationTime;
+
+	void Save(const btRigidBody& rb);
+	void Restore(btRigidBody& rb) const;
+};
+
+struct CarSnapshot {
+	uint32_t id;
+	CarState state;
+	CarControls controls;
+	Vec velocityImpulseCache;
+	RigidBodySnapshot rigidBody;
+	btWheelInfoRL wheels[4];
+};
+
+struct BallSnapshot {
+	BallState state;
+	Vec velocityImpulseCache;
+	bool groundStickApplied;
+	RigidBodySnapshot rigidBody;
+};
+
+// Plain copy of everything needed to continue simulating an arena from a point in time
+// Unlike Serialize() or Clone(), restoring it doesn't construct anything, so it is fast enough to do every episode
+// NOTE: Can only be restored to the arena it was saved from, with the same cars (cars are matched by ID)
+struct ArenaSnapshot {
+	uint64_t tickCount;
+	BallSnapshot ball;
+	std::vector<CarSnapshot> cars;
+	std::vector<BoostPadState> boostPads;
+};
+
+RS_NS_END
@@ -0,0 +1,103 @@
+#include "MeshTriangleGrid.h"
+
+#include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "../../../libsrc/bullet3-3.24/LinearMath/btAabbUtil2.h"
+
+RS_NS_START
+
+struct CollectTrianglesCallback : public btTriangleCallback {
+	std::vector<MeshTriangleGrid::Triangle>& triangles;
+
+	CollectTrianglesCallback(std::vector<MeshTriangleGrid::Triangle>& triangles) : triangles(triangles) {}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
+		MeshTriangleGrid::Triangle tri = {};
+		for (int i = 0; i < 3; i++)
+			tri.verts[i] = triangle[i];
+		tri.partId = partId;
+		tri.triangleIndex = triangleIndex;
+		triangles.push_back(tri);
+	}
+};
+
+void MeshTriangleGrid::Build(btBvhTriangleMeshShape* shape) {
+	shape->getAabb(btTransform::getIdentity(), aabbMin, aabbMax);
+
+	triangles.clear();
+	CollectTrianglesCallback collectCallback = CollectTrianglesCallback(triangles);
+	shape->processAllTriangles(&collectCallback, aabbMin, aabbMax);
+
+	btVector3 extent = aabbMax - aabbMin;
+	float cellSize = RS_MAX(extent[extent.maxAxis()], SIMD_EPSILON) / CELL_AMOUNT_LONGEST_AXIS;
+	for (int i = 0; i < 3; i++) {
+		cellAmount[i] = RS_CLAMP((int)ceilf(extent[i] / cellSize), 1, CELL_AMOUNT_LONGEST_AXIS);
+		invCellSize[i] = 1 / cellSize;
+	}
+
+	int totalCells = cellAmount[0] * cellAmount[1] * cellAmount[2];
+
+	// Counting sort of the triangles into the cells they overlap
+	std::vector<uint32_t> cellCounts = std::vector<uint32_t>(totalCells + 1);
+	auto forEachCell = [&](Triangle& tri, auto fn) {
+		btVector3 triMin = tri.verts[0], triMax = tri.verts[0];
+		for (int i = 1; i < 3; i++) {
+			triMin.setMin(tri.verts[i]);
+			triMax.setMax(tri.verts[i]);
+		}
+
+		int maxCell[3];
+		GetCellIndicesFromPos(triMin, tri.minCell);
+		GetCellIndicesFromPos(triMax, maxCell);
+
+		for (int i = tri.minCell[0]; i <= maxCell[0]; i++)
+			for (int j = tri.minCell[1]; j <= maxCell[1]; j++)
+				for (int k = tri.minCell[2]; k <= maxCell[2]; k++)
+					fn(GetCellIndex(i, j, k));
+	};
+
+	for (Triangle& tri : triangles)
+		forEachCell(tri, [&](int cellIndex) { cellCounts[cellIndex + 1]++; });
+
+	cellStarts.resize(totalCells + 1);
+	cellStarts[0] = 0;
+	for (int i = 0; i < totalCells; i++)
+		cellStarts[i + 1] = cellStarts[i] + cellCounts[i + 1];
+
+	cellTriangles.resize(cellStarts[totalCells]);
+	std::vector<uint32_t> cellFill = std::vector<uint32_t>(cellStarts.begin(), cellStarts.end() - 1);
+	for (uint32_t triIndex = 0; triIndex < triangles.size(); triIndex++)
+		forEachCell(triangles[triIndex], [&](int cellIndex) { cellTriangles[cellFill[cellIndex]++] = triIndex; });
+}
+
+void MeshTriangleGrid::ProcessTrianglesInAABB(btTriangleCallback* callback, const btVector3& min, const btVector3& max) const {
+	if (!TestAabbAgainstAabb2(min, max, aabbMin, aabbMax))
+		return;
+
+	int minCell[3], maxCell[3];
+	GetCellIndicesFromPos(min, minCell);
+	GetCellIndicesFromPos(max, maxCell);
+
+	for (int i = minCell[0]; i <= maxCell[0]; i++) {
+		for (int j = minCell[1]; j <= maxCell[1]; j++) {
+			for (int k = minCell[2]; k <= maxCell[2]; k++) {
+				int cellIndex = GetCellIndex(i, j, k);
+				for (uint32_t n = cellStarts[cellIndex]; n < cellStarts[cellIndex + 1]; n++) {
+					const Triangle& tri = triangles[cellTriangles[n]];
+
+					// A triangle spanning multiple cells is only reported from the first of them that is in the query
+					if (RS_MAX(tri.minCell[0], minCell[0]) != i || RS_MAX(tri.minCell[1], minCell[1]) != j || RS_MAX(tri.minCell[2], minCell[2]) != k)
+						continue;
+
+					btVector3 verts[3] = { tri.verts[0], tri.verts[1], tri.verts[2] };
+					callback->processTriangle(verts, tri.partId, tri.triangleIndex);
+				}
+			}
+		}
+	}
+}
+
+const MeshTriangleGrid* MeshTriangleGrid::Get(const btBvhTriangleMeshShape* shape) {
+	return (const MeshTriangleGrid*)shape->getUserPointer();
+}
+
+RS_NS_END
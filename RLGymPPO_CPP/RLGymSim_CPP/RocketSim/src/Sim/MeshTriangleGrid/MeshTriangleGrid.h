@@ -0,0 +1,58 @@
+#pragma once
+#include "../../BaseInc.h"
+
+#include "../../../libsrc/bullet3-3.24/LinearMath/btVector3.h"
+
+class btBvhTriangleMeshShape;
+class btTriangleCallback;
+
+RS_NS_START
+
+// Uniform grid of triangle lists over a static triangle mesh, in the mesh's local space
+// Finding the triangles near a point or short ray is then just a few cell lookups, instead of a walk down the mesh's BVH
+// Triangles are stored exactly as btBvhTriangleMeshShape::processAllTriangles() gives them, so callbacks see identical data
+//
+// Built once in RocketSim::Init() for each arena mesh, and attached to the mesh shape's user pointer
+// Read-only after building, so it is shared by every arena
+struct MeshTriangleGrid {
+	// Amount of cells along the longest axis of the mesh
+	constexpr static int CELL_AMOUNT_LONGEST_AXIS = 64;
+
+	struct Triangle {
+		btVector3 verts[3];
+		int partId, triangleIndex;
+
+		// Index of the cell containing the triangle's AABB min, used so that each triangle is only reported once per query
+		int minCell[3];
+	};
+
+	btVector3 aabbMin, aabbMax;
+	btVector3 invCellSize;
+	int cellAmount[3];
+
+	std::vector<Triangle> triangles;
+
+	// Triangles of cell N are cellTriangles[cellStarts[N]] to cellTriangles[cellStarts[N + 1]]
+	std::vector<uint32_t> cellStarts;
+	std::vector<uint32_t> cellTriangles;
+
+	void Build(btBvhTriangleMeshShape* shape);
+
+	// Calls the callback for every triangle whose cells overlap the AABB (in the mesh's local space)
+	// Like the BVH, this can include triangles that don't actually overlap it
+	void ProcessTrianglesInAABB(btTriangleCallback* callback, const btVector3& min, const btVector3& max) const;
+
+	int GetCellIndex(int i, int j, int k) const {
+		return (i * cellAmount[1] + j) * cellAmount[2] + k;
+	}
+
+	void GetCellIndicesFromPos(const btVector3& pos, int* indicesOut) const {
+		for (int i = 0; i < 3; i++)
+			indicesOut[i] = (int)RS_CLAMP((pos[i] - aabbMin[i]) * invCellSize[i], 0, cellAmount[i] - 1);
+	}
+
+	// Returns the grid attached to this shape, or NULL if there isn't one
+	static const MeshTriangleGrid* Get(const btBvhTriangleMeshShape* shape);
+};
+
+RS_NS_END
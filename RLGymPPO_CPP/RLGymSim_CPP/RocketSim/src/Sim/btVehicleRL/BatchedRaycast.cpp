@@ -0,0 +1,211 @@
+#include "BatchedRaycast.h"
+
+#include "../MeshTriangleGrid/MeshTriangleGrid.h"
+
+#include "../../../libsrc/bullet3-3.24/BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "../../../libsrc/bullet3-3.24/BulletDynamics/Dynamics/btRigidBody.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
+
+#include <optional>
+
+RS_NS_START
+
+// Just collects the objects the broadphase would have ray-tested
+struct CandidateCollectCallback : public btBroadphaseRayCallback {
+	std::vector<btCollisionObject*>& candidates;
+
+	CandidateCollectCallback(const btVector3& rayFromWorld, const btVector3& rayToWorld, std::vector<btCollisionObject*>& candidates)
+		: candidates(candidates) {
+
+		// Same setup as btSingleRayCallback, since some broadphases use these
+		btVector3 rayDir = (rayToWorld - rayFromWorld);
+		rayDir.normalize();
+		m_rayDirectionInverse[0] = rayDir[0] == 0 ? BT_LARGE_FLOAT : 1 / rayDir[0];
+		m_rayDirectionInverse[1] = rayDir[1] == 0 ? BT_LARGE_FLOAT : 1 / rayDir[1];
+		m_rayDirectionInverse[2] = rayDir[2] == 0 ? BT_LARGE_FLOAT : 1 / rayDir[2];
+		m_signs[0] = m_rayDirectionInverse[0] < 0.0;
+		m_signs[1] = m_rayDirectionInverse[1] < 0.0;
+		m_signs[2] = m_rayDirectionInverse[2] < 0.0;
+		m_lambda_max = rayDir.dot(rayToWorld - rayFromWorld);
+	}
+
+	virtual bool process(const btBroadphaseProxy* proxy) {
+		candidates.push_back((btCollisionObject*)proxy->m_clientObject);
+		return true;
+	}
+};
+
+// Same as the BridgeTriangleRaycastCallback in btCollisionWorld::rayTestSingleInternal()
+struct MeshRaycastCallback : public btTriangleRaycastCallback {
+	btCollisionWorld::RayResultCallback* resultCallback;
+	const btCollisionObject* collisionObject;
+	btTransform colObjWorldTransform;
+
+	MeshRaycastCallback(const btVector3& from, const btVector3& to, btCollisionWorld::RayResultCallback* resultCallback, const btCollisionObject* collisionObject)
+		: btTriangleRaycastCallback(from, to, resultCallback->m_flags), resultCallback(resultCallback),
+		collisionObject(collisionObject), colObjWorldTransform(collisionObject->getWorldTransform()) {
+		m_hitFraction = resultCallback->m_closestHitFraction;
+	}
+
+	virtual btScalar reportHit(const btVector3& hitNormalLocal, btScalar hitFraction, int partId, int triangleIndex) {
+		btCollisionWorld::LocalShapeInfo shapeInfo;
+		shapeInfo.m_shapePart = partId;
+		shapeInfo.m_triangleIndex = triangleIndex;
+
+		btVector3 hitNormalWorld = colObjWorldTransform.getBasis() * hitNormalLocal;
+		btCollisionWorld::LocalRayResult rayResult(collisionObject, &shapeInfo, hitNormalWorld, hitFraction);
+		return resultCallback->addSingleResult(rayResult, true);
+	}
+};
+
+// Passes each triangle from one mesh traversal to every ray
+struct MultiRayTriangleCallback : public btTriangleCallback {
+	std::optional<MeshRaycastCallback>* rayCallbacks;
+	int rayCount;
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
+		for (int i = 0; i < rayCount; i++)
+			if (rayCallbacks[i])
+				rayCallbacks[i]->processTriangle(triangle, partId, triangleIndex);
+	}
+};
+
+void CastRaysBatched(
+	btDynamicsWorld* world, const btVector3* sources, const btVector3* targets, int rayCount, const btCollisionObject* ignoreObj,
+	btCollisionObject** objectsOut, btVehicleRaycaster::btVehicleRaycasterResult* resultsOut) {
+
+	assert(rayCount > 0 && rayCount <= BATCHED_RAYCAST_MAX_RAYS);
+
+	// Re-used between calls to avoid allocations
+	thread_local std::vector<btCollisionObject*> rayCandidates;
+	thread_local std::vector<std::pair<btCollisionObject*, uint32_t>> objects; // Unique candidates, with a bitmask of the rays that found them
+
+	objects.clear();
+	for (int i = 0; i < rayCount; i++) {
+		rayCandidates.clear();
+		CandidateCollectCallback collectCallback = CandidateCollectCallback(sources[i], targets[i], rayCandidates);
+		world->getBroadphase()->rayTest(sources[i], targets[i], collectCallback);
+
+		for (btCollisionObject* obj : rayCandidates) {
+			bool found = false;
+			for (auto& pair : objects) {
+				if (pair.first == obj) {
+					pair.second |= (1 << i);
+					found = true;
+					break;
+				}
+			}
+
+			if (!found)
+				objects.push_back({ obj, 1u << i });
+		}
+	}
+
+	std::optional<btCollisionWorld::ClosestRayResultCallback> resultCallbacks[BATCHED_RAYCAST_MAX_RAYS];
+	btTransform fromTransforms[BATCHED_RAYCAST_MAX_RAYS], toTransforms[BATCHED_RAYCAST_MAX_RAYS];
+	for (int i = 0; i < rayCount; i++) {
+		resultCallbacks[i].emplace(sources[i], targets[i], ignoreObj);
+		fromTransforms[i] = btTransform(btMatrix3x3::getIdentity(), sources[i]);
+		toTransforms[i] = btTransform(btMatrix3x3::getIdentity(), targets[i]);
+	}
+
+	for (auto& pair : objects) {
+		btCollisionObject* obj = pair.first;
+
+		uint32_t activeMask = 0;
+		int activeCount = 0;
+		for (int i = 0; i < rayCount; i++) {
+			if (!(pair.second & (1 << i)))
+				continue;
+
+			auto& resultCallback = *resultCallbacks[i];
+			if (resultCallback.m_closestHitFraction == 0 || !resultCallback.needsCollision(obj->getBroadphaseHandle()))
+				continue;
+
+			activeMask |= (1 << i);
+			activeCount++;
+		}
+
+		if (activeCount == 0)
+			continue;
+
+		const btCollisionShape* shape = obj->getCollisionShape();
+		const MeshTriangleGrid* triGrid = NULL;
+		if (shape->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE)
+			triGrid = MeshTriangleGrid::Get((const btBvhTriangleMeshShape*)shape);
+
+		if (triGrid) {
+			// Only check the triangles in the cells each ray passes through
+			btTransform worldToObj = obj->getWorldTransform().inverse();
+			for (int i = 0; i < rayCount; i++) {
+				if (!(activeMask & (1 << i)))
+					continue;
+
+				btVector3 fromLocal = worldToObj * sources[i];
+				btVector3 toLocal = worldToObj * targets[i];
+				MeshRaycastCallback meshCallback = MeshRaycastCallback(fromLocal, toLocal, &*resultCallbacks[i], obj);
+
+				btVector3 rayMin = fromLocal, rayMax = fromLocal;
+				rayMin.setMin(toLocal);
+				rayMax.setMax(toLocal);
+				triGrid->ProcessTrianglesInAABB(&meshCallback, rayMin, rayMax);
+			}
+		} else if (activeCount > 1 && shape->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE) {
+			// One traversal of the mesh's BVH, using the bounds of all of the rays
+			btTransform worldToObj = obj->getWorldTransform().inverse();
+
+			std::optional<MeshRaycastCallback> meshCallbacks[BATCHED_RAYCAST_MAX_RAYS];
+			btVector3 aabbMin = btVector3(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+			btVector3 aabbMax = -aabbMin;
+			for (int i = 0; i < rayCount; i++) {
+				if (!(activeMask & (1 << i)))
+					continue;
+
+				btVector3 fromLocal = worldToObj * sources[i];
+				btVector3 toLocal = worldToObj * targets[i];
+				meshCallbacks[i].emplace(fromLocal, toLocal, &*resultCallbacks[i], obj);
+
+				aabbMin.setMin(fromLocal);
+				aabbMin.setMin(toLocal);
+				aabbMax.setMax(fromLocal);
+				aabbMax.setMax(toLocal);
+			}
+
+			MultiRayTriangleCallback multiCallback = {};
+			multiCallback.rayCallbacks = meshCallbacks;
+			multiCallback.rayCount = rayCount;
+			((const btBvhTriangleMeshShape*)shape)->processAllTriangles(&multiCallback, aabbMin, aabbMax);
+		} else {
+			for (int i = 0; i < rayCount; i++) {
+				if (!(activeMask & (1 << i)))
+					continue;
+
+				btCollisionWorld::rayTestSingle(
+					fromTransforms[i], toTransforms[i],
+					obj, shape, obj->getWorldTransform(),
+					*resultCallbacks[i]
+				);
+			}
+		}
+	}
+
+	// Same result handling as btDefaultVehicleRaycaster::castRay()
+	for (int i = 0; i < rayCount; i++) {
+		auto& resultCallback = *resultCallbacks[i];
+		objectsOut[i] = NULL;
+
+		if (resultCallback.hasHit()) {
+			const btRigidBody* body = btRigidBody::upcast(resultCallback.m_collisionObject);
+			if (body && body->hasContactResponse()) {
+				resultsOut[i].m_hitPointInWorld = resultCallback.m_hitPointWorld;
+				resultsOut[i].m_hitNormalInWorld = resultCallback.m_hitNormalWorld;
+				resultsOut[i].m_hitNormalInWorld.normalize();
+				resultsOut[i].m_distFraction = resultCallback.m_closestHitFraction;
+				objectsOut[i] = (btCollisionObject*)body;
+			}
+		}
+	}
+}
+
+RS_NS_END
@@ -0,0 +1,21 @@
+#pragma once
+#include "../../BaseInc.h"
+
+#include "../../../libsrc/bullet3-3.24/BulletDynamics/Vehicle/btDefaultVehicleRaycaster.h"
+
+RS_NS_START
+
+// Casts multiple rays against a world at once
+// Results are the same as calling btDefaultVehicleRaycaster::castRay() for each ray,
+//	except that triangles at the exact same distance along a ray may be picked in a different order
+// Static triangle meshes with a MeshTriangleGrid are checked through the grid cells each ray passes through
+// Other static triangle meshes are only traversed once for all of the rays that could hit them, instead of once per ray
+// objectsOut is set to NULL for rays that don't hit anything
+void CastRaysBatched(
+	btDynamicsWorld* world, const btVector3* sources, const btVector3* targets, int rayCount, const btCollisionObject* ignoreObj,
+	btCollisionObject** objectsOut, btVehicleRaycaster::btVehicleRaycasterResult* resultsOut
+);
+
+constexpr int BATCHED_RAYCAST_MAX_RAYS = 4;
+
+RS_NS_END
@@ -3,6 +3,7 @@
 #define ROLLING_INFLUENCE_FIX
 
 #include "../SuspensionCollisionGrid/SuspensionCollisionGrid.h"
+#include "BatchedRaycast.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/Dynamics/btDynamicsWorld.h"
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/ConstraintSolver/btContactConstraint.h"
@@ -115,20 +116,25 @@ void btVehicleRL::updateWheelTransformsWS(btWheelInfoRL& wheel) {
 	wheel.m_raycastInfo.m_wheelAxleWS = chassisTrans.getBasis() * wheel.m_wheelAxleCS;
 }
 
-float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid) {
+float btVehicleRL::prepareRay(btWheelInfoRL& wheel, btVector3& sourceOut, btVector3& targetOut) {
 	updateWheelTransformsWS(wheel);
 
-	float depth = -1;
-
 	float suspensionTravel = wheel.m_maxSuspensionTravelCm / 100;
 	float realRayLength = wheel.getSuspensionRestLength() + suspensionTravel + wheel.m_wheelsRadius - RLConst::BTVehicle::SUSPENSION_SUBTRACTION;
 
 	// See: I21
-	btVector3 source = wheel.m_raycastInfo.m_hardPointWS;
-	btVector3 target = source + (wheel.m_raycastInfo.m_wheelDirectionWS * realRayLength);
-	wheel.m_raycastInfo.m_contactPointWS = target;
+	sourceOut = wheel.m_raycastInfo.m_hardPointWS;
+	targetOut = sourceOut + (wheel.m_raycastInfo.m_wheelDirectionWS * realRayLength);
+	wheel.m_raycastInfo.m_contactPointWS = targetOut;
 	wheel.m_raycastInfo.m_groundObject = NULL;
 
+	return realRayLength;
+}
+
+float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid) {
+	btVector3 source, target;
+	float realRayLength = prepareRay(wheel, source, target);
+
 	// See: I22
 	btVehicleRaycaster::btVehicleRaycasterResult rayResults;
 	
@@ -140,6 +146,13 @@ float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid)
 		object = (btCollisionObject*)m_vehicleRaycaster->castRay(source, target, m_chassisBody, rayResults);
 	}
 
+	return applyRayResult(wheel, object, rayResults, realRayLength);
+}
+
+float btVehicleRL::applyRayResult(btWheelInfoRL& wheel, btCollisionObject* object, const btVehicleRaycaster::btVehicleRaycasterResult& rayResults, float realRayLength) {
+	float depth = -1;
+	float suspensionTravel = wheel.m_maxSuspensionTravelCm / 100;
+
 	// See: I23
 	if (object) {
 		wheel.m_raycastInfo.m_contactPointWS = rayResults.m_hitPointInWorld;
@@ -224,11 +237,23 @@ void btVehicleRL::updateVehicleFirst(float step, SuspensionCollisionGrid* grid)
 	// simulate suspension
 	//
 
-	int i = 0;
-	for (i = 0; i < m_wheelInfo.size(); i++) {
-		//float depth;
-		//depth =
-		rayCast(m_wheelInfo[i], grid);
+	if (grid || !m_batchedRaycast || m_wheelInfo.size() > BATCHED_RAYCAST_MAX_RAYS) {
+		for (int i = 0; i < m_wheelInfo.size(); i++)
+			rayCast(m_wheelInfo[i], grid);
+	} else {
+		// Cast all of the wheel rays at once, so the arena mesh BVHs are only traversed once
+		btVector3 sources[BATCHED_RAYCAST_MAX_RAYS], targets[BATCHED_RAYCAST_MAX_RAYS];
+		float realRayLengths[BATCHED_RAYCAST_MAX_RAYS];
+		for (int i = 0; i < m_wheelInfo.size(); i++)
+			realRayLengths[i] = prepareRay(m_wheelInfo[i], sources[i], targets[i]);
+
+		btCollisionObject* objects[BATCHED_RAYCAST_MAX_RAYS];
+		btVehicleRaycaster::btVehicleRaycasterResult rayResults[BATCHED_RAYCAST_MAX_RAYS];
+		CastRaysBatched(m_dynamicsWorld, sources, targets, m_wheelInfo.size(), m_chassisBody, objects, rayResults);
+
+		// Applied in wheel order, since static collisions change the chassis velocity
+		for (int i = 0; i < m_wheelInfo.size(); i++)
+			applyRayResult(m_wheelInfo[i], objects[i], rayResults[i], realRayLengths[i]);
 	}
 
 	calcFrictionImpulses(step);
@@ -61,6 +61,7 @@ public:
 	};
 
 	btVehicleRaycaster* m_vehicleRaycaster;
+	bool m_batchedRaycast = true; // Cast all wheel rays at once with CastRaysBatched(), instead of one at a time through m_vehicleRaycaster
 	float m_pitchControl;
 	float m_steeringValue;
 
@@ -86,7 +87,10 @@ public:
 
 	const btTransform& getChassisWorldTransform() const;
 
+	// Updates the wheel's world transform and computes its suspension ray, returns the ray length
+	float prepareRay(btWheelInfoRL& wheel, btVector3& sourceOut, btVector3& targetOut);
 	float rayCast(btWheelInfoRL& wheel, struct SuspensionCollisionGrid* grid);
+	float applyRayResult(btWheelInfoRL& wheel, btCollisionObject* object, const btVehicleRaycaster::btVehicleRaycasterResult& rayResults, float realRayLength);
 
 	void updateVehicleFirst(float step, struct SuspensionCollisionGrid* grid);
 	void updateVehicleSecond(float step);
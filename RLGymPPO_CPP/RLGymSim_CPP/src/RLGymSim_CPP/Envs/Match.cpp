@@ -14,9 +14,15 @@ namespace RLGSC {
 
 		obsBuilder->PreStep(state);
 
+		int obsSize = obsBuilder->GetOBSSize(state);
 		for (int i = 0; i < state.players.size(); i++) {
-			result[i] =
-				obsBuilder->BuildOBS(state.players[i], state, prevActions[i]);
+			if (obsSize > 0) {
+				result[i].resize(obsSize);
+				obsBuilder->BuildOBSInto(state.players[i], state, prevActions[i], result[i].data());
+			} else {
+				result[i] =
+					obsBuilder->BuildOBS(state.players[i], state, prevActions[i]);
+			}
 		}
 
 		return result;
@@ -26,7 +32,8 @@ namespace RLGSC {
 		auto result = FList(state.players.size());
 
 		rewardFn->PreStep(state);
-		return rewardFn->GetAllRewards(state, prevActions, done);
+		rewardFn->GetAllRewardsInto(state, prevActions, done, result.data());
+		return result;
 	}
 
 	bool Match::IsDone(const GameState& state) {
@@ -51,6 +58,17 @@ namespace RLGSC {
 		return actions;
 	}
 
+	void Match::ParseActionsInto(const ActionParser::Input& actionsData, const GameState& gameState, Arena* arena) {
+		RG_ASSERT(gameState.players.size() <= 64);
+
+		uint64_t demoMask = 0;
+		for (int i = 0; i < gameState.players.size(); i++)
+			if (gameState.players[i].carState.isDemoed)
+				demoMask |= 1ull << i;
+
+		actionParser->ParseActionsInto(actionsData, gameState, prevActions, arena, demoMask);
+	}
+
 	GameState Match::ResetState(Arena* arena) {
 		GameState newState = stateSetter->ResetState(arena);
 
@@ -24,6 +24,10 @@ namespace RLGSC {
 
 		ActionSet prevActions;
 
+		// Inverted GameState fields to compute every step (see GameStateFields)
+		// Everything else is computed on first access, so this only needs to list fields that are read directly instead of through the getters
+		uint8_t gameStateFields = GSF_ALL;
+
 		Match(
 			RewardFunction* rewardFn,
 			std::vector<TerminalCondition*> terminalConditions,
@@ -51,6 +55,10 @@ namespace RLGSC {
 		bool IsDone(const GameState& state);
 		ScoreLine GetScoreLine(const GameState& state);
 		ActionSet ParseActions(const ActionParser::Input& actionsData, const GameState& gameState);
+
+		// Parses actions into prevActions and the controls of the arena's cars, without building a new ActionSet
+		// Demoed players get empty actions
+		void ParseActionsInto(const ActionParser::Input& actionsData, const GameState& gameState, Arena* arena);
 		GameState ResetState(Arena* arena);
 	};
 }
\ No newline at end of file
@@ -66,22 +66,17 @@ namespace RLGSC {
 	}
 
 	Gym::StepResult Gym::Step(const ActionParser::Input& actionsData) {
-		ActionSet actions = match->ParseActions(actionsData, prevState);
-		match->prevActions = actions;
+		// Also sets the controls of the cars
+		match->ParseActionsInto(actionsData, prevState, arena);
 
 		GameState state;
 
 		{ // Step arena with actions
-			auto carItr = arena->_cars.begin();
-			for (int i = 0; i < actions.size(); i++) {
-				(*carItr)->controls = (CarControls)actions[i];
-				carItr++;
-			}
-
 			arena->Step(tickSkip - actionDelay);
 			if (arena->gameMode != GameMode::HEATSEEKER)
 				eventTracker.Update(arena);
 			state = prevState; // All callbacks have been hit
+			state.eagerFields = match->gameStateFields;
 			state.UpdateFromArena(arena);
 			arena->Step(actionDelay);
 			totalTicks += tickSkip;
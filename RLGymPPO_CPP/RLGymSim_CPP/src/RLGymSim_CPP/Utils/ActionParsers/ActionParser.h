@@ -11,6 +11,28 @@ namespace RLGSC {
 		typedef IList Input;
 
 		virtual ActionSet ParseActions(const Input& actionsData, const GameState& gameState) = 0;
+
+		// Parses the action of just one player
+		// Parsers that don't depend on the other players should override this, so it doesn't have to parse every player's action
+		virtual Action ParseAction(int actionData, int playerIndex, const GameState& gameState) {
+			Input actionsData = Input(gameState.players.size(), 0);
+			actionsData[playerIndex] = actionData;
+			return ParseActions(actionsData, gameState)[playerIndex];
+		}
+
+		// Parses actions into actionsOut (which is re-used, so nothing is allocated once it has the right size),
+		//	and writes their controls straight into the arena's cars (which are in the same order as gameState.players)
+		// Players with their bit set in zeroMask get an empty action (see Match::ParseActionsInto())
+		// Parsers with a fixed action table should override this, so no intermediate ActionSet has to be built
+		virtual void ParseActionsInto(const Input& actionsData, const GameState& gameState, ActionSet& actionsOut, Arena* arena, uint64_t zeroMask = 0) {
+			actionsOut = ParseActions(actionsData, gameState);
+			for (int i = 0; i < actionsOut.size(); i++) {
+				if ((zeroMask >> i) & 1)
+					actionsOut[i] = {};
+				arena->_cars[i]->controls = (CarControls)actionsOut[i];
+			}
+		}
+
 		virtual int GetActionAmount() = 0;
 	};
 }
\ No newline at end of file
@@ -7,19 +7,64 @@ namespace RLGSC {
 	class DiscreteAction : public ActionParser {
 	public:
 
-		std::vector<Action> actions;
+		// Built once and shared by every DiscreteAction
+		struct LookupTable {
+			std::vector<Action> actions;
+			std::vector<CarControls> controls; // Same as actions, already converted
+
+			LookupTable() = default;
+			LookupTable(std::vector<Action> actions);
+		};
+		static const LookupTable& GetLookupTable();
+
+	private:
+		// Only set if this parser has its own actions (declared before the references below, so it is constructed first)
+		std::shared_ptr<const LookupTable> _customTable;
+
+	public:
+		const std::vector<Action>& actions;
+		const std::vector<CarControls>& controls;
 
 		DiscreteAction();
 
+		// Uses these actions instead of the shared table
+		// To customize the actions in a subclass, pass them to this constructor (the shared table is read-only)
+		DiscreteAction(std::vector<Action> customActions);
+
 		virtual ActionSet ParseActions(const Input& actionsData, const GameState& gameState) {
 			ActionSet result;
+			result.reserve(actionsData.size());
 			for (int idx : actionsData)
 				result.push_back(actions[idx]);
 			return result;
 		}
 
+		virtual Action ParseAction(int actionData, int playerIndex, const GameState& gameState) {
+			return actions[actionData];
+		}
+
+		virtual void ParseActionsInto(const Input& actionsData, const GameState& gameState, ActionSet& actionsOut, Arena* arena, uint64_t zeroMask = 0) {
+			// Subclasses may override ParseActions(), which reading the table directly would skip
+			if (typeid(*this) != typeid(DiscreteAction)) {
+				ActionParser::ParseActionsInto(actionsData, gameState, actionsOut, arena, zeroMask);
+				return;
+			}
+
+			actionsOut.resize(actionsData.size());
+			for (int i = 0; i < actionsData.size(); i++) {
+				if ((zeroMask >> i) & 1) {
+					actionsOut[i] = {};
+					arena->_cars[i]->controls = {};
+				} else {
+					int idx = actionsData[i];
+					actionsOut[i] = actions[idx];
+					arena->_cars[i]->controls = controls[idx];
+				}
+			}
+		}
+
 		virtual int GetActionAmount() {
 			return actions.size();
 		}
 	};
-}
\ No newline at end of file
+}
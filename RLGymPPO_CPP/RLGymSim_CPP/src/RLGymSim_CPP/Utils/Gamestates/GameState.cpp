@@ -55,20 +55,23 @@ void RLGSC::GameState::UpdateFromArena(Arena* arena) {
 
 	deltaTime = tickSkip * (1 / 120.f);
 
+	bool eagerPhysInv = eagerFields & GSF_PHYS_INV;
+
 	ballState = arena->ball->GetState();
 	ball = PhysObj(ballState);
-	ballInv = ball.Invert();
+	_ballInvValid = false;
+	if (eagerPhysInv)
+		GetBallPhys(true);
 
 	players.resize(arena->_cars.size());
 
-	auto carItr = arena->_cars.begin();
 	for (int i = 0; i < players.size(); i++) {
 		auto& player = players[i];
-		player.UpdateFromCar(*carItr, arena->tickCount, tickSkip);
+		player.UpdateFromCar(arena->_cars[i], arena->tickCount, tickSkip);
+		if (eagerPhysInv)
+			player.GetPhys(true);
 		if (player.ballTouchedStep)
 			lastTouchCarID = player.carId;
-
-		carItr++;
 	}
 
 	if (!boostPadIndexMapBuilt) {
@@ -82,19 +85,15 @@ void RLGSC::GameState::UpdateFromArena(Arena* arena) {
 	}
 
 	for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
-		int idx = boostPadIndexMap[i];
-		int invIdx = boostPadIndexMap[CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1];
-
-		auto state = arena->_boostPads[idx]->GetState();
-		auto stateInv = arena->_boostPads[invIdx]->GetState();
-
+		auto state = arena->_boostPads[boostPadIndexMap[i]]->GetState();
 		boostPads[i] = state.isActive;
-		boostPadsInv[i] = stateInv.isActive;
-
 		boostPadTimers[i] = state.cooldown;
-		boostPadTimersInv[i] = stateInv.cooldown;
 	}
 
+	_boostPadsInvValid = false;
+	if (eagerFields & GSF_BOOST_PADS_INV)
+		_UpdateBoostPadsInv();
+
 	// Update goal scoring
 	// If you don't have a GoalScoreCondition then that's not my problem lmao
 	if (Math::IsBallScored(ball.pos))
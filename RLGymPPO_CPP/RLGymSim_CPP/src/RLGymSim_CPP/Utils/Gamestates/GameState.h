@@ -15,6 +15,16 @@ namespace RLGSC {
 		}
 	};
 
+	// Inverted parts of the GameState that UpdateFromArena() computes right away
+	// Parts that aren't listed are only computed the first time they are accessed through a getter
+	//	(GetBallPhys(), PlayerData::GetPhys(), GetBoostPads(), GetBoostPadTimers()), so only read those fields directly if they are listed here
+	enum GameStateFields : uint8_t {
+		GSF_NONE = 0,
+		GSF_PHYS_INV = (1 << 0), // ballInv, and physInv of each player
+		GSF_BOOST_PADS_INV = (1 << 1), // boostPadsInv and boostPadTimersInv
+		GSF_ALL = 0xFF
+	};
+
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/gamestates/game_state.py
 	struct GameState {
 		float deltaTime = 0; // Time that has passed since last update
@@ -24,13 +34,18 @@ namespace RLGSC {
 		std::vector<PlayerData> players;
 
 		BallState ballState;
-		PhysObj ball, ballInv;
+		PhysObj ball;
+		mutable PhysObj ballInv;
 
 		std::array<bool, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPads;
-		std::array<bool, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadsInv;
+		mutable std::array<bool, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadsInv;
 
 		std::array<float, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadTimers;
-		std::array<float, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadTimersInv;
+		mutable std::array<float, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadTimersInv;
+
+		// See GameStateFields, set from Match::gameStateFields by the Gym
+		uint8_t eagerFields = GSF_ALL;
+		mutable bool _ballInvValid = false, _boostPadsInvValid = false;
 
 		// Last arena we updated with
 		// Can be used to determine current arena from within reward function, for example
@@ -46,11 +61,43 @@ namespace RLGSC {
 		}
 
 		const PhysObj& GetBallPhys(bool inverted) const {
-			return inverted ? ballInv : ball;
+			if (!inverted)
+				return ball;
+
+			if (!_ballInvValid) {
+				ballInv = ball.Invert();
+				_ballInvValid = true;
+			}
+			return ballInv;
 		}
 
 		const auto& GetBoostPads(bool inverted) const {
-			return inverted ? boostPadsInv : boostPads;
+			if (!inverted)
+				return boostPads;
+
+			_UpdateBoostPadsInv();
+			return boostPadsInv;
+		}
+
+		const auto& GetBoostPadTimers(bool inverted) const {
+			if (!inverted)
+				return boostPadTimers;
+
+			_UpdateBoostPadsInv();
+			return boostPadTimersInv;
+		}
+
+		// The inverted pad order is just the normal pad order reversed
+		void _UpdateBoostPadsInv() const {
+			if (_boostPadsInvValid)
+				return;
+
+			for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
+				int invIdx = CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1;
+				boostPadsInv[i] = boostPads[invIdx];
+				boostPadTimersInv[i] = boostPadTimers[invIdx];
+			}
+			_boostPadsInvValid = true;
 		}
 
 		void UpdateFromArena(Arena* arena);
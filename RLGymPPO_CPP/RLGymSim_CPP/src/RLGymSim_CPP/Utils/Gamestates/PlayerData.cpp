@@ -15,7 +15,7 @@ namespace RLGSC {
 		carState = newState;
 
 		phys = PhysObj(carState);
-		physInv = PhysObj(phys.Invert());
+		_physInvValid = false;
 
 		if (carState.ballHitInfo.isValid) {
 			ballTouchedStep = carState.ballHitInfo.tickCountWhenHit >= (tickCount - tickSkip);
@@ -8,7 +8,9 @@ namespace RLGSC {
 		uint32_t carId;
 		Team team;
 
-		PhysObj phys, physInv;
+		PhysObj phys;
+		mutable PhysObj physInv; // Use GetPhys(true), see GameStateFields
+		mutable bool _physInvValid = false;
 		CarState carState;
 
 		// matchAssists: being the passer to a teammate who shot and scored
@@ -33,7 +35,14 @@ namespace RLGSC {
 		void UpdateFromCar(Car* car, uint64_t tickCount, int tickSkip);
 
 		const PhysObj& GetPhys(bool inverted) const {
-			return inverted ? physInv : phys;
+			if (!inverted)
+				return phys;
+
+			if (!_physInvValid) {
+				physInv = phys.Invert();
+				_physInvValid = true;
+			}
+			return physInv;
 		}
 	};
 }
\ No newline at end of file
@@ -1,56 +1,69 @@
 #include "DefaultOBS.h"
 
+inline float* WriteVec(float* out, const Vec& vec) {
+	out[0] = vec.x;
+	out[1] = vec.y;
+	out[2] = vec.z;
+	return out + 3;
+}
+
 void RLGSC::DefaultOBS::AddPlayerToOBS(FList& obs, const PlayerData& player, bool inv) {
-	PhysObj phys = player.GetPhys(inv);
-
-	obs += phys.pos * posCoef;
-	obs += phys.rotMat.forward;
-	obs += phys.rotMat.up;
-	obs += phys.vel * velCoef;
-	obs += phys.angVel * angVelCoef,
-		
-	obs += {
-		player.boostFraction,
-		(float)player.carState.isOnGround,
-		(float)player.hasFlip,
-		(float)player.carState.isDemoed,
-	};
+	float playerObs[PLAYER_OBS_SIZE];
+	WritePlayerOBS(playerObs, player, inv);
+	obs.insert(obs.end(), playerObs, playerObs + PLAYER_OBS_SIZE);
 }
 
-RLGSC::FList RLGSC::DefaultOBS::BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) {
-	FList result = {};
+float* RLGSC::DefaultOBS::WritePlayerOBS(float* out, const PlayerData& player, bool inv) const {
+	const PhysObj& phys = player.GetPhys(inv);
 
-	bool inv = player.team == Team::ORANGE;
+	out = WriteVec(out, phys.pos * posCoef);
+	out = WriteVec(out, phys.rotMat.forward);
+	out = WriteVec(out, phys.rotMat.up);
+	out = WriteVec(out, phys.vel * velCoef);
+	out = WriteVec(out, phys.angVel * angVelCoef);
 
+	out[0] = player.boostFraction;
+	out[1] = (float)player.carState.isOnGround;
+	out[2] = (float)player.hasFlip;
+	out[3] = (float)player.carState.isDemoed;
+	return out + 4;
+}
+
+float* RLGSC::DefaultOBS::WriteBaseOBS(float* out, const GameState& state, const Action& prevAction, bool inv) const {
 	auto& ball = state.GetBallPhys(inv);
 	auto& pads = state.GetBoostPads(inv);
 
-	result += ball.pos * posCoef;
-	result += ball.vel * velCoef;
-	result += ball.angVel * angVelCoef;
+	out = WriteVec(out, ball.pos * posCoef);
+	out = WriteVec(out, ball.vel * velCoef);
+	out = WriteVec(out, ball.angVel * angVelCoef);
 
 	for (int i = 0; i < prevAction.ELEM_AMOUNT; i++)
-		result += prevAction[i];
+		*(out++) = prevAction[i];
 
 	for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++)
-		result += (float)pads[i];
+		*(out++) = (float)pads[i];
+
+	return out;
+}
 
-	AddPlayerToOBS(result, player, inv);
+RLGSC::FList RLGSC::DefaultOBS::BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) {
+	FList result = FList(GetDefaultOBSSize(state));
+	DefaultOBS::BuildOBSInto(player, state, prevAction, result.data());
+	return result;
+}
 
-	FList teammates = {}, opponents = {};
+void RLGSC::DefaultOBS::BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, float* out) {
+	bool inv = player.team == Team::ORANGE;
 
-	for (auto& otherPlayer : state.players) {
-		if (otherPlayer.carId == player.carId)
-			continue;
+	out = WriteBaseOBS(out, state, prevAction, inv);
+	out = WritePlayerOBS(out, player, inv);
 
-		AddPlayerToOBS(
-			(otherPlayer.team == player.team) ? teammates : opponents,
-			otherPlayer,
-			inv
-		);
-	}
+	// Teammates, then opponents
+	for (auto& otherPlayer : state.players)
+		if (otherPlayer.team == player.team && otherPlayer.carId != player.carId)
+			out = WritePlayerOBS(out, otherPlayer, inv);
 
-	result += teammates;
-	result += opponents;
-	return result;
-}
\ No newline at end of file
+	for (auto& otherPlayer : state.players)
+		if (otherPlayer.team != player.team)
+			out = WritePlayerOBS(out, otherPlayer, inv);
+}
@@ -1,11 +1,18 @@
 #pragma once
 #include "OBSBuilder.h"
+#include <typeinfo>
 
 // https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/obs_builders/default_obs.py
 namespace RLGSC {
 	class DefaultOBS : public OBSBuilder {
 	public:
 
+		// Ball, previous action and boost pads
+		constexpr static int BASE_OBS_SIZE = (3 * 3) + Action::ELEM_AMOUNT + CommonValues::BOOST_LOCATIONS_AMOUNT;
+
+		// Size of the observation of each player (self, teammates, and opponents)
+		constexpr static int PLAYER_OBS_SIZE = (3 * 5) + 4;
+
 		Vec posCoef;
 		float velCoef, angVelCoef;
 		DefaultOBS(
@@ -18,6 +25,21 @@ namespace RLGSC {
 
 		void AddPlayerToOBS(FList& obs, const PlayerData& player, bool inv);
 
+		// These write PLAYER_OBS_SIZE or BASE_OBS_SIZE floats and return the pointer after the last one
+		float* WritePlayerOBS(float* out, const PlayerData& player, bool inv) const;
+		float* WriteBaseOBS(float* out, const GameState& state, const Action& prevAction, bool inv) const;
+
 		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction);
+
+		int GetDefaultOBSSize(const GameState& state) const {
+			return BASE_OBS_SIZE + PLAYER_OBS_SIZE * state.players.size();
+		}
+
+		// Subclasses that only override BuildOBS() would otherwise inherit our fast path and layout,
+		//	so they have to override this (and BuildOBSInto()) to use it
+		virtual int GetOBSSize(const GameState& state) {
+			return (typeid(*this) == typeid(DefaultOBS)) ? GetDefaultOBSSize(state) : 0;
+		}
+		virtual void BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, float* out);
 	};
-}
\ No newline at end of file
+}
@@ -1,67 +1,51 @@
 #include "DefaultOBSPadded.h"
 
 RLGSC::FList RLGSC::DefaultOBSPadded::BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) {
-	FList result = {};
+	FList result = FList(GetPaddedOBSSize());
+	DefaultOBSPadded::BuildOBSInto(player, state, prevAction, result.data());
+	return result;
+}
 
+void RLGSC::DefaultOBSPadded::BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, float* out) {
 	bool inv = player.team == Team::ORANGE;
 
-	auto& ball = state.GetBallPhys(inv);
-	auto& pads = state.GetBoostPads(inv);
-
-	result += ball.pos * posCoef;
-	result += ball.vel * velCoef;
-	result += ball.angVel * angVelCoef;
-
-	for (int i = 0; i < prevAction.ELEM_AMOUNT; i++)
-		result += prevAction[i];
-
-	for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++)
-		result += (float)pads[i];
+	out = WriteBaseOBS(out, state, prevAction, inv);
+	out = WritePlayerOBS(out, player, inv);
 
-	FList selfOBS = {};
-	AddPlayerToOBS(selfOBS, player, inv);
-	result += selfOBS;
-	int playerObsSize = selfOBS.size();
-
-	FList2 teammates = {}, opponents = {};
+	// Player slots are local so that one builder can be used from multiple threads, NULL slots are padding
+	const PlayerData* teammateSlots[MAX_PLAYERS_LIMIT] = {};
+	const PlayerData* opponentSlots[MAX_PLAYERS_LIMIT] = {};
+	int numTeammates = 0, numOpponents = 0;
 
 	for (auto& otherPlayer : state.players) {
 		if (otherPlayer.carId == player.carId)
 			continue;
 
-		FList playerObs = {};
-		AddPlayerToOBS(
-			playerObs,
-			otherPlayer,
-			inv
-		);
-		((otherPlayer.team == player.team) ? teammates : opponents).push_back(playerObs);
+		if (otherPlayer.team == player.team) {
+			if (numTeammates >= maxPlayers - 1)
+				RG_ERR_CLOSE("DefaultOBSPadded: Too many teammates for OBS, maximum is " << (maxPlayers - 1));
+			teammateSlots[numTeammates++] = &otherPlayer;
+		} else {
+			if (numOpponents >= maxPlayers)
+				RG_ERR_CLOSE("DefaultOBSPadded: Too many opponents for OBS, maximum is " << maxPlayers);
+			opponentSlots[numOpponents++] = &otherPlayer;
+		}
 	}
 
-	if (teammates.size() > maxPlayers - 1)
-		RG_ERR_CLOSE("DefaultOBSPadded: Too many teammates for OBS, maximum is " << (maxPlayers - 1));
-	
-	if (opponents.size() > maxPlayers)
-		RG_ERR_CLOSE("DefaultOBSPadded: Too many opponents for OBS, maximum is " << maxPlayers);
+	// Shuffle both lists
+	std::shuffle(teammateSlots, teammateSlots + (maxPlayers - 1), ::Math::GetRandEngine());
+	std::shuffle(opponentSlots, opponentSlots + maxPlayers, ::Math::GetRandEngine());
 
 	for (int i = 0; i < 2; i++) {
-		auto& playerList = i ? teammates : opponents;
-		int targetCount = i ? maxPlayers - 1 : maxPlayers;
-
-		while (playerList.size() < targetCount) {
-			FList pad = FList(playerObsSize);
-			playerList.push_back(pad);
+		const PlayerData** slots = i ? opponentSlots : teammateSlots;
+		int numSlots = i ? maxPlayers : (maxPlayers - 1);
+		for (int j = 0; j < numSlots; j++) {
+			if (slots[j]) {
+				out = WritePlayerOBS(out, *slots[j], inv);
+			} else {
+				std::fill(out, out + PLAYER_OBS_SIZE, 0.f);
+				out += PLAYER_OBS_SIZE;
+			}
 		}
 	}
-
-	// Shuffle both lists
-	std::shuffle(teammates.begin(), teammates.end(), ::Math::GetRandEngine());
-	std::shuffle(opponents.begin(), opponents.end(), ::Math::GetRandEngine());
-
-	for (auto& teammate : teammates)
-		result += teammate;
-	for (auto& opponent : opponents)
-		result += opponent;
-
-	return result;
-}
\ No newline at end of file
+}
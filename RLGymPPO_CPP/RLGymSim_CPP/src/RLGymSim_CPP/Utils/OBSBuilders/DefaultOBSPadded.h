@@ -8,6 +8,9 @@ namespace RLGSC {
 	class DefaultOBSPadded : public DefaultOBS {
 	public:
 
+		// Upper limit for maxPlayers, so player slots can live on the stack
+		constexpr static int MAX_PLAYERS_LIMIT = 32;
+
 		int maxPlayers;
 
 		DefaultOBSPadded(
@@ -16,9 +19,21 @@ namespace RLGSC {
 			float velCoef = 1 / CommonValues::CAR_MAX_SPEED,
 			float angVelCoef = 1 / CommonValues::CAR_MAX_ANG_VEL
 		) : DefaultOBS(posCoef, velCoef, angVelCoef), maxPlayers(maxPlayers) {
-
+			if (maxPlayers < 1 || maxPlayers > MAX_PLAYERS_LIMIT)
+				RG_ERR_CLOSE("DefaultOBSPadded: maxPlayers must be from 1 to " << MAX_PLAYERS_LIMIT << ", got " << maxPlayers);
 		}
 
 		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction);
+
+		int GetPaddedOBSSize() const {
+			// Self, (maxPlayers - 1) teammates, and maxPlayers opponents
+			return BASE_OBS_SIZE + PLAYER_OBS_SIZE * (maxPlayers * 2);
+		}
+
+		// See DefaultOBS::GetOBSSize()
+		virtual int GetOBSSize(const GameState& state) {
+			return (typeid(*this) == typeid(DefaultOBSPadded)) ? GetPaddedOBSSize() : 0;
+		}
+		virtual void BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, float* out);
 	};
-}
\ No newline at end of file
+}
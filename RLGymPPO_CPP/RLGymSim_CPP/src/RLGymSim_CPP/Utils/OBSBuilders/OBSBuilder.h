@@ -13,5 +13,31 @@ namespace RLGSC {
 
 		// NOTE: May be called once during environment initialization to determine policy neuron size
 		virtual FList BuildOBS(const PlayerData& player, const GameState& state, const Action& prevAction) = 0;
+
+		// Optional fast path that writes observations directly to memory, instead of returning a new FList each time
+		// Builders that support it return their observation size for this state here, and implement BuildOBSInto()
+		// Returns 0 if BuildOBSInto() isn't supported
+		virtual int GetOBSSize(const GameState& state) { return 0; }
+
+		// Writes exactly GetOBSSize(state) floats to "out"
+		virtual void BuildOBSInto(const PlayerData& player, const GameState& state, const Action& prevAction, float* out) {}
+
+		// Builds the observations of every player into "out", with each player's observation "stride" floats after the last one
+		// Observations must fit in the stride
+		void BuildAll(const GameState& state, const ActionSet& prevActions, float* out, int stride) {
+			int obsSize = GetOBSSize(state);
+			for (int i = 0; i < state.players.size(); i++) {
+				float* playerOut = out + (size_t)i * stride;
+				if (obsSize > 0) {
+					assert(obsSize <= stride);
+					BuildOBSInto(state.players[i], state, prevActions[i], playerOut);
+				} else {
+					FList obs = BuildOBS(state.players[i], state, prevActions[i]);
+					if (obs.size() > stride)
+						RG_ERR_CLOSE("OBSBuilder::BuildAll(): Observation size (" << obs.size() << ") is larger than the stride (" << stride << ")");
+					std::copy(obs.begin(), obs.end(), playerOut);
+				}
+			}
+		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,88 @@
+#include "ReplayDataset.h"
+
+using namespace RLGSC;
+
+ReplayDataset::ReplayDataset(std::shared_ptr<const ReplayFile> file, OBSBuilder* obsBuilder, ActionParser* actionParser) :
+	file(file), obsBuilder(obsBuilder), actionParser(actionParser) {
+
+	constexpr const char* ERR_PREFIX = "ReplayDataset(): ";
+
+	RG_ASSERT(file && obsBuilder && actionParser);
+	if (file->numFrames == 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "Replay file has no frames");
+
+	file->GetGameState(0, _state);
+
+	// Parse every action once, so recorded controls can be matched against them
+	for (int i = 0; i < actionParser->GetActionAmount(); i++)
+		_actionTable.push_back(actionParser->ParseAction(i, 0, _state));
+
+	obsBuilder->Reset(_state);
+	obsBuilder->PreStep(_state);
+	obsSize = obsBuilder->BuildOBS(_state.players[0], _state, Action()).size();
+}
+
+bool ReplayDataset::NextBatch(int maxSamples, FList& obsOut, IList& actionsOut) {
+	constexpr const char* ERR_PREFIX = "ReplayDataset::NextBatch(): ";
+
+	int numCars = file->header.numCars;
+	if (maxSamples < numCars)
+		RG_ERR_CLOSE(ERR_PREFIX << "Batches must fit at least one frame (" << numCars << " samples)");
+
+	if (nextFrame >= file->numFrames)
+		return false;
+
+	int builderOBSSize = obsBuilder->GetOBSSize(_state);
+	for (int samples = 0; samples + numCars <= maxSamples && nextFrame < file->numFrames; samples += numCars) {
+		file->GetGameState(nextFrame, _state);
+
+		if (file->IsSequenceStart(nextFrame) || nextFrame == 0) {
+			obsBuilder->Reset(_state);
+			_prevActions = ActionSet(numCars);
+		}
+
+		obsBuilder->PreStep(_state);
+		file->GetActions(nextFrame, _actions);
+
+		for (int i = 0; i < numCars; i++) {
+			size_t obsStart = obsOut.size();
+			if (builderOBSSize > 0) {
+				obsOut.resize(obsStart + builderOBSSize);
+				obsBuilder->BuildOBSInto(_state.players[i], _state, _prevActions[i], obsOut.data() + obsStart);
+			} else {
+				obsOut += obsBuilder->BuildOBS(_state.players[i], _state, _prevActions[i]);
+			}
+
+			if (obsOut.size() - obsStart != obsSize)
+				RG_ERR_CLOSE(ERR_PREFIX << "Observation size changed from " << obsSize << " to " << (obsOut.size() - obsStart));
+
+			actionsOut.push_back(GetActionIndex(_actions[i]));
+		}
+
+		// The policy would see the parsed action it picked, not the recorded controls
+		for (int i = 0; i < numCars; i++)
+			_prevActions[i] = _actionTable[actionsOut[actionsOut.size() - numCars + i]];
+
+		nextFrame++;
+	}
+
+	return true;
+}
+
+int ReplayDataset::GetActionIndex(const Action& action) const {
+	int bestIndex = 0;
+	float bestDistSq = FLT_MAX;
+	for (int i = 0; i < _actionTable.size(); i++) {
+		float distSq = 0;
+		for (int j = 0; j < Action::ELEM_AMOUNT; j++) {
+			float delta = _actionTable[i][j] - action[j];
+			distSq += delta * delta;
+		}
+
+		if (distSq < bestDistSq) {
+			bestDistSq = distSq;
+			bestIndex = i;
+		}
+	}
+	return bestIndex;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "ReplayFile.h"
+#include "../OBSBuilders/OBSBuilder.h"
+#include "../ActionParsers/ActionParser.h"
+
+namespace RLGSC {
+	// Turns a replay file into (observation, action index) samples, e.g. for pretraining a policy
+	// Every player of each frame is one sample, observations are built with a normal OBSBuilder,
+	//	and recorded controls are matched to the closest action of the action parser
+	class ReplayDataset {
+	public:
+		std::shared_ptr<const ReplayFile> file;
+		OBSBuilder* obsBuilder; // Not owned
+		ActionParser* actionParser; // Not owned
+
+		int obsSize;
+
+		// Next frame NextBatch() will read
+		size_t nextFrame = 0;
+
+		ReplayDataset(std::shared_ptr<const ReplayFile> file, OBSBuilder* obsBuilder, ActionParser* actionParser);
+
+		RG_NO_COPY(ReplayDataset);
+
+		size_t GetNumSamples() const {
+			return file->numFrames * file->header.numCars;
+		}
+
+		// Appends samples from the next frames, in file order, until another frame wouldn't fit in maxSamples
+		// Observations go to obsOut (obsSize floats each), action indices go to actionsOut
+		// Returns false once every frame has been read (see Restart())
+		bool NextBatch(int maxSamples, FList& obsOut, IList& actionsOut);
+
+		void Restart() {
+			nextFrame = 0;
+		}
+
+		// Index of the parser action closest to a recorded action
+		int GetActionIndex(const Action& action) const;
+
+	private:
+		std::vector<Action> _actionTable;
+		GameState _state;
+		ActionSet _actions, _prevActions;
+	};
+}
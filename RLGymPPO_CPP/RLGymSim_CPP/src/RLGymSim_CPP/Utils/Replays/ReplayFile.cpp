@@ -0,0 +1,264 @@
+#include "ReplayFile.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace RLGSC;
+
+void _WriteVec(float* out, const Vec& vec) {
+	out[0] = vec.x;
+	out[1] = vec.y;
+	out[2] = vec.z;
+}
+
+Vec _ReadVec(const float* in) {
+	return Vec(in[0], in[1], in[2]);
+}
+
+ReplayWriter::ReplayWriter(std::filesystem::path path, int numCars, int tickSkip, int chunkFrames) :
+	numCars(numCars), tickSkip(tickSkip), _chunkFrames(RS_MAX(chunkFrames, 1)) {
+
+	_fileStream = std::ofstream(path, std::ios::binary | std::ios::trunc);
+	if (!_fileStream.good())
+		RG_ERR_CLOSE("ReplayWriter(): Failed to open " << path << " for writing");
+
+	ReplayFileHeader header = {};
+	memcpy(header.magic, REPLAY_FILE_MAGIC, sizeof(header.magic));
+	header.version = REPLAY_FILE_VERSION;
+	header.numCars = numCars;
+	header.tickSkip = tickSkip;
+	_fileStream.write((const char*)&header, sizeof(header));
+
+	_chunk.reserve(GetReplayFrameSize(numCars) * _chunkFrames);
+	_carsBuffer.resize(numCars);
+}
+
+ReplayWriter::~ReplayWriter() {
+	Flush();
+}
+
+void ReplayWriter::WriteFrame(const GameState& state, const ActionSet& actions, bool sequenceStart) {
+	if (state.players.size() != numCars || actions.size() != numCars)
+		RG_ERR_CLOSE("ReplayWriter::WriteFrame(): Expected " << numCars << " players and actions, got " << state.players.size() << " and " << actions.size());
+
+	ReplayFrameHeader frame;
+	EncodeFrame(state, actions, sequenceStart || numFramesWritten == 0, frame, _carsBuffer.data());
+
+	_chunk.insert(_chunk.end(), (const byte*)&frame, (const byte*)(&frame + 1));
+	_chunk.insert(_chunk.end(), (const byte*)_carsBuffer.data(), (const byte*)(_carsBuffer.data() + numCars));
+	numFramesWritten++;
+
+	if (_chunk.size() >= GetReplayFrameSize(numCars) * _chunkFrames)
+		Flush();
+}
+
+void ReplayWriter::WriteRawFrame(const void* frame) {
+	const byte* frameBytes = (const byte*)frame;
+	_chunk.insert(_chunk.end(), frameBytes, frameBytes + GetReplayFrameSize(numCars));
+	if (numFramesWritten == 0)
+		((ReplayFrameHeader*)(_chunk.data() + _chunk.size() - GetReplayFrameSize(numCars)))->flags |= RFF_SEQUENCE_START;
+	numFramesWritten++;
+
+	if (_chunk.size() >= GetReplayFrameSize(numCars) * _chunkFrames)
+		Flush();
+}
+
+void ReplayWriter::Flush() {
+	if (_chunk.empty())
+		return;
+
+	_fileStream.write((const char*)_chunk.data(), _chunk.size());
+	_fileStream.flush();
+	if (!_fileStream.good())
+		RG_ERR_CLOSE("ReplayWriter::Flush(): Failed to write to file");
+
+	_chunk.clear();
+}
+
+void ReplayWriter::EncodeFrame(const GameState& state, const ActionSet& actions, bool sequenceStart, ReplayFrameHeader& frameOut, ReplayCar* carsOut) {
+	frameOut = {};
+	frameOut.flags = sequenceStart ? RFF_SEQUENCE_START : 0;
+	_WriteVec(frameOut.ballPos, state.ball.pos);
+	_WriteVec(frameOut.ballVel, state.ball.vel);
+	_WriteVec(frameOut.ballAngVel, state.ball.angVel);
+
+	for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++)
+		if (state.boostPads[i])
+			frameOut.boostPads[i / 32] |= 1u << (i % 32);
+
+	for (int i = 0; i < state.players.size(); i++) {
+		const PlayerData& player = state.players[i];
+		const CarState& carState = player.carState;
+		ReplayCar& car = carsOut[i];
+		car = {};
+
+		_WriteVec(car.pos, player.phys.pos);
+		_WriteVec(car.forward, player.phys.rotMat.forward);
+		_WriteVec(car.right, player.phys.rotMat.right);
+		_WriteVec(car.up, player.phys.rotMat.up);
+		_WriteVec(car.vel, player.phys.vel);
+		_WriteVec(car.angVel, player.phys.angVel);
+		car.boost = carState.boost;
+		car.team = (uint32_t)player.team;
+
+		car.flags =
+			(carState.isOnGround ? RCF_ON_GROUND : 0) |
+			(carState.hasJumped ? RCF_HAS_JUMPED : 0) |
+			(carState.hasDoubleJumped ? RCF_HAS_DOUBLE_JUMPED : 0) |
+			(carState.hasFlipped ? RCF_HAS_FLIPPED : 0) |
+			(player.hasJump ? RCF_HAS_JUMP : 0) |
+			(player.hasFlip ? RCF_HAS_FLIP : 0) |
+			(carState.isDemoed ? RCF_DEMOED : 0) |
+			(player.ballTouchedStep ? RCF_BALL_TOUCHED : 0);
+
+		for (int j = 0; j < Action::ELEM_AMOUNT; j++)
+			car.action[j] = actions[i][j];
+	}
+}
+
+ReplayFile::ReplayFile(std::filesystem::path path) {
+	constexpr const char* ERR_PREFIX = "ReplayFile(): ";
+
+#if defined(_WIN32)
+	HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to open " << path);
+
+	LARGE_INTEGER fileSize = {};
+	GetFileSizeEx(fileHandle, &fileSize);
+	_dataSize = fileSize.QuadPart;
+
+	if (_dataSize > 0) {
+		_mapHandle = CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (_mapHandle)
+			_data = (const byte*)MapViewOfFile(_mapHandle, FILE_MAP_READ, 0, 0, 0);
+	}
+	CloseHandle(fileHandle);
+#else
+	int fileDesc = open(path.c_str(), O_RDONLY);
+	if (fileDesc < 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to open " << path);
+
+	struct stat fileStat = {};
+	fstat(fileDesc, &fileStat);
+	_dataSize = fileStat.st_size;
+
+	if (_dataSize > 0) {
+		void* mapped = mmap(NULL, _dataSize, PROT_READ, MAP_SHARED, fileDesc, 0);
+		if (mapped != MAP_FAILED)
+			_data = (const byte*)mapped;
+	}
+	close(fileDesc);
+#endif
+
+	if (_dataSize < sizeof(ReplayFileHeader))
+		RG_ERR_CLOSE(ERR_PREFIX << "File " << path << " is too small to be a replay file");
+
+	if (!_data)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to memory-map " << path);
+
+	memcpy(&header, _data, sizeof(header));
+	if (memcmp(header.magic, REPLAY_FILE_MAGIC, sizeof(header.magic)) != 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "File " << path << " is not a replay file");
+
+	if (header.version != REPLAY_FILE_VERSION)
+		RG_ERR_CLOSE(ERR_PREFIX << "File " << path << " has version " << header.version << ", expected " << REPLAY_FILE_VERSION);
+
+	frameSize = GetReplayFrameSize(header.numCars);
+	_frames = _data + sizeof(ReplayFileHeader);
+	numFrames = (_dataSize - sizeof(ReplayFileHeader)) / frameSize;
+
+	if ((_dataSize - sizeof(ReplayFileHeader)) % frameSize != 0)
+		RG_LOG("ReplayFile(): WARNING: " << path << " ends with a partial frame, it will be ignored");
+
+#if !defined(_WIN32)
+	// Frames are mostly read at random (e.g. by ReplayState)
+	madvise((void*)_data, _dataSize, MADV_RANDOM);
+#endif
+}
+
+ReplayFile::~ReplayFile() {
+#if defined(_WIN32)
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mapHandle)
+		CloseHandle(_mapHandle);
+#else
+	if (_data)
+		munmap((void*)_data, _dataSize);
+#endif
+}
+
+void ReplayFile::GetGameState(size_t index, GameState& stateOut) const {
+	const ReplayFrameHeader& frame = GetFrame(index);
+	const ReplayCar* cars = GetCars(index);
+
+	stateOut.deltaTime = header.tickSkip / 120.f;
+	stateOut.lastArena = NULL;
+
+	stateOut.ballState = {};
+	stateOut.ballState.pos = _ReadVec(frame.ballPos);
+	stateOut.ballState.vel = _ReadVec(frame.ballVel);
+	stateOut.ballState.angVel = _ReadVec(frame.ballAngVel);
+	stateOut.ball = PhysObj(stateOut.ballState);
+	stateOut._ballInvValid = false;
+
+	for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
+		stateOut.boostPads[i] = (frame.boostPads[i / 32] >> (i % 32)) & 1;
+		stateOut.boostPadTimers[i] = 0;
+	}
+	stateOut._boostPadsInvValid = false;
+
+	stateOut.players.resize(header.numCars);
+	for (int i = 0; i < header.numCars; i++) {
+		const ReplayCar& car = cars[i];
+		PlayerData& player = stateOut.players[i];
+		player = {};
+
+		player.carId = i + 1;
+		player.team = (Team)car.team;
+
+		CarState& carState = player.carState;
+		carState.pos = _ReadVec(car.pos);
+		carState.rotMat = RotMat(_ReadVec(car.forward), _ReadVec(car.right), _ReadVec(car.up));
+		carState.vel = _ReadVec(car.vel);
+		carState.angVel = _ReadVec(car.angVel);
+		carState.boost = car.boost;
+		carState.isOnGround = car.flags & RCF_ON_GROUND;
+		carState.hasJumped = car.flags & RCF_HAS_JUMPED;
+		carState.hasDoubleJumped = car.flags & RCF_HAS_DOUBLE_JUMPED;
+		carState.hasFlipped = car.flags & RCF_HAS_FLIPPED;
+		carState.isDemoed = car.flags & RCF_DEMOED;
+
+		player.phys = PhysObj(carState);
+		player.hasJump = car.flags & RCF_HAS_JUMP;
+		player.hasFlip = car.flags & RCF_HAS_FLIP;
+		player.boostFraction = car.boost / 100;
+		player.ballTouchedStep = player.ballTouchedTick = car.flags & RCF_BALL_TOUCHED;
+		if (player.ballTouchedStep)
+			stateOut.lastTouchCarID = player.carId;
+
+		if (stateOut.eagerFields & GSF_PHYS_INV)
+			player.GetPhys(true);
+	}
+
+	if (stateOut.eagerFields & GSF_PHYS_INV)
+		stateOut.GetBallPhys(true);
+	if (stateOut.eagerFields & GSF_BOOST_PADS_INV)
+		stateOut._UpdateBoostPadsInv();
+}
+
+void ReplayFile::GetActions(size_t index, ActionSet& actionsOut) const {
+	const ReplayCar* cars = GetCars(index);
+	actionsOut.resize(header.numCars);
+	for (int i = 0; i < header.numCars; i++)
+		for (int j = 0; j < Action::ELEM_AMOUNT; j++)
+			actionsOut[i][j] = cars[i].action[j];
+}
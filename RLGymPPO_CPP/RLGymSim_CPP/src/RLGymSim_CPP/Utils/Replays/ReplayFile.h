@@ -0,0 +1,127 @@
+#pragma once
+#include "../Gamestates/GameState.h"
+#include "../BasicTypes/Action.h"
+
+// Binary format for recorded games, read by ReplayState and ReplayDataset
+//	Layout: ReplayFileHeader, then every frame back to back
+//	Each frame is a ReplayFrameHeader followed by a ReplayCar for every car, so all frames are the same size,
+//	and the file can be memory-mapped and indexed directly without parsing anything
+//	Frames are grouped into sequences (e.g. one replay, or the part of one between kickoffs), files can be concatenated by just appending frames
+// NOTE: Little-endian only
+namespace RLGSC {
+	constexpr char REPLAY_FILE_MAGIC[4] = { 'R', 'G', 'R', 'F' };
+	constexpr uint32_t REPLAY_FILE_VERSION = 1;
+
+	struct ReplayFileHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t numCars;
+		uint32_t tickSkip; // Ticks between frames
+	};
+
+	enum ReplayFrameFlags : uint32_t {
+		RFF_SEQUENCE_START = (1 << 0)
+	};
+
+	struct ReplayFrameHeader {
+		uint32_t flags; // See ReplayFrameFlags
+		float ballPos[3], ballVel[3], ballAngVel[3];
+
+		// Bit i is set if boost pad i (in CommonValues::BOOST_LOCATIONS order) is active
+		uint32_t boostPads[2];
+	};
+
+	enum ReplayCarFlags : uint32_t {
+		RCF_ON_GROUND = (1 << 0),
+		RCF_HAS_JUMPED = (1 << 1),
+		RCF_HAS_DOUBLE_JUMPED = (1 << 2),
+		RCF_HAS_FLIPPED = (1 << 3),
+		RCF_HAS_JUMP = (1 << 4), // PlayerData::hasJump
+		RCF_HAS_FLIP = (1 << 5), // PlayerData::hasFlip
+		RCF_DEMOED = (1 << 6),
+		RCF_BALL_TOUCHED = (1 << 7) // PlayerData::ballTouchedStep
+	};
+
+	struct ReplayCar {
+		float pos[3], forward[3], right[3], up[3], vel[3], angVel[3];
+		float boost; // From 0 to 100
+		uint32_t team;
+		uint32_t flags; // See ReplayCarFlags
+
+		// Controls the car used from this frame until the next one
+		float action[Action::ELEM_AMOUNT];
+	};
+
+	static_assert(sizeof(ReplayFileHeader) == 16 && sizeof(ReplayFrameHeader) == 48 && sizeof(ReplayCar) == 116, "Unexpected replay record padding");
+
+	inline size_t GetReplayFrameSize(int numCars) {
+		return sizeof(ReplayFrameHeader) + sizeof(ReplayCar) * numCars;
+	}
+
+	// Streams frames to a file, frames are buffered and written a chunk at a time
+	class ReplayWriter {
+	public:
+		int numCars, tickSkip;
+		uint64_t numFramesWritten = 0;
+
+		ReplayWriter(std::filesystem::path path, int numCars, int tickSkip, int chunkFrames = 4096);
+		~ReplayWriter();
+
+		RG_NO_COPY(ReplayWriter);
+
+		// Cars are written in the order of state.players
+		void WriteFrame(const GameState& state, const ActionSet& actions, bool sequenceStart);
+
+		// "frame" must be GetReplayFrameSize(numCars) bytes
+		void WriteRawFrame(const void* frame);
+
+		void Flush();
+
+		static void EncodeFrame(const GameState& state, const ActionSet& actions, bool sequenceStart, ReplayFrameHeader& frameOut, ReplayCar* carsOut);
+
+	private:
+		std::ofstream _fileStream;
+		std::vector<byte> _chunk;
+		size_t _chunkFrames;
+		std::vector<ReplayCar> _carsBuffer;
+	};
+
+	// Read-only, memory-mapped replay file
+	// Can be shared by many threads
+	class ReplayFile {
+	public:
+		ReplayFileHeader header;
+		size_t frameSize;
+		size_t numFrames;
+
+		explicit ReplayFile(std::filesystem::path path);
+		~ReplayFile();
+
+		RG_NO_COPY(ReplayFile);
+
+		const ReplayFrameHeader& GetFrame(size_t index) const {
+			assert(index < numFrames);
+			return *(const ReplayFrameHeader*)(_frames + index * frameSize);
+		}
+
+		const ReplayCar* GetCars(size_t index) const {
+			return (const ReplayCar*)(&GetFrame(index) + 1);
+		}
+
+		bool IsSequenceStart(size_t index) const {
+			return GetFrame(index).flags & RFF_SEQUENCE_START;
+		}
+
+		// Fills in "stateOut" in-place, players are in the file's car order
+		// NOTE: Boost pad timers and match stats aren't recorded, and are always 0
+		void GetGameState(size_t index, GameState& stateOut) const;
+
+		void GetActions(size_t index, ActionSet& actionsOut) const;
+
+	private:
+		const byte* _data = NULL;
+		const byte* _frames = NULL;
+		size_t _dataSize = 0;
+		void* _mapHandle = NULL;
+	};
+}
@@ -3,12 +3,60 @@
 
 // https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/combined_reward.py
 namespace RLGSC {
+	// Running stats of one reward term, only numbers so it can be updated every step
+	struct RewardTermProfile {
+		double time = 0; // Total seconds spent getting this term's rewards
+		int64_t count = 0;
+		double mean = 0, varianceSum = 0, absSum = 0;
+
+		// Takes the weighted contribution of one player
+		void Add(float val) {
+			count++;
+			double delta = val - mean;
+			mean += delta / count;
+			varianceSum += delta * (val - mean);
+			absSum += abs(val);
+		}
+
+		// Chan's parallel algorithm, same as WelfordRunningStat
+		void Merge(const RewardTermProfile& other) {
+			time += other.time;
+			if (other.count <= 0)
+				return;
+
+			int64_t totalCount = count + other.count;
+			double otherRatio = other.count / (double)totalCount;
+			double delta = other.mean - mean;
+			mean += delta * otherRatio;
+			varianceSum += other.varianceSum + delta * delta * count * otherRatio;
+			absSum += other.absSum;
+			count = totalCount;
+		}
+
+		double GetAbsMean() const {
+			return count > 0 ? absSum / count : 0;
+		}
+
+		double GetSTD() const {
+			return count > 1 ? sqrt(varianceSum / (count - 1)) : 0;
+		}
+	};
+
 	class CombinedReward : public RewardFunction {
 	public:
 		std::vector<RewardFunction*> rewardFuncs;
 		std::vector<float> rewardWeights;
 		bool ownsFuncs;
 
+		// If true, the time and weighted contribution of each reward function are tracked in termProfiles
+		// Each CombinedReward has its own profiles, so there is no locking; merge them with MergeProfiles()
+		bool profile = false;
+
+		// Names of each reward function, used for the metric names (defaults to "Term <index>")
+		std::vector<std::string> termNames;
+
+		std::vector<RewardTermProfile> termProfiles;
+
 		CombinedReward(std::vector<RewardFunction*> rewardFuncs, std::vector<float> rewardWeights, bool ownsFuncs = false) :
 			rewardFuncs(rewardFuncs), rewardWeights(rewardWeights), ownsFuncs(ownsFuncs) {
 			assert(rewardFuncs.size() == rewardWeights.size());
@@ -22,6 +70,30 @@ namespace RLGSC {
 			}
 		}
 
+		void EnableProfiling(const std::vector<std::string>& termNames = {}) {
+			assert(termNames.empty() || termNames.size() == rewardFuncs.size());
+			this->termNames = termNames;
+			profile = true;
+			ResetProfiles();
+		}
+
+		std::string GetTermName(int index) const {
+			return index < termNames.size() ? termNames[index] : ("Term " + std::to_string(index));
+		}
+
+		// Adds the profiles of this reward into a list of merged profiles (one per reward function)
+		void MergeProfiles(std::vector<RewardTermProfile>& merged) const {
+			if (merged.size() < termProfiles.size())
+				merged.resize(termProfiles.size());
+
+			for (int i = 0; i < termProfiles.size(); i++)
+				merged[i].Merge(termProfiles[i]);
+		}
+
+		void ResetProfiles() {
+			termProfiles.assign(rewardFuncs.size(), {});
+		}
+
 	protected:
 		virtual void Reset(const GameState& initialState) {
 			for (auto func : rewardFuncs)
@@ -35,16 +107,55 @@ namespace RLGSC {
 
 		virtual std::vector<float> GetAllRewards(const GameState& state, const ActionSet& prevAction, bool final) {
 			std::vector<float> allRewards(state.players.size());
+			CombinedReward::GetAllRewardsInto(state, prevAction, final, allRewards.data());
+			return allRewards;
+		}
+
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevAction, bool final, float* rewardsOut) {
+			int playerAmount = state.players.size();
+			std::fill(rewardsOut, rewardsOut + playerAmount, 0.f);
+
+			_funcRewards.resize(playerAmount);
+
+			if (profile) {
+				_GetAllRewardsProfiled(state, prevAction, final, rewardsOut);
+				return;
+			}
 
 			for (int i = 0; i < rewardFuncs.size(); i++) {
-				auto rewards = rewardFuncs[i]->GetAllRewards(state, prevAction, final);
-				for (int j = 0; j < rewards.size(); j++)
-					allRewards[j] += rewards[j] * rewardWeights[i];
+				rewardFuncs[i]->GetAllRewardsInto(state, prevAction, final, _funcRewards.data());
+
+				float weight = rewardWeights[i];
+				for (int j = 0; j < playerAmount; j++)
+					rewardsOut[j] += _funcRewards[j] * weight;
 			}
+		}
 
-			return allRewards;
+		void _GetAllRewardsProfiled(const GameState& state, const ActionSet& prevAction, bool final, float* rewardsOut) {
+			int playerAmount = state.players.size();
+			if (termProfiles.size() != rewardFuncs.size())
+				ResetProfiles();
+
+			for (int i = 0; i < rewardFuncs.size(); i++) {
+				auto startTime = std::chrono::steady_clock::now();
+				rewardFuncs[i]->GetAllRewardsInto(state, prevAction, final, _funcRewards.data());
+				auto endTime = std::chrono::steady_clock::now();
+
+				RewardTermProfile& termProfile = termProfiles[i];
+				termProfile.time += std::chrono::duration<double>(endTime - startTime).count();
+
+				float weight = rewardWeights[i];
+				for (int j = 0; j < playerAmount; j++) {
+					float contribution = _funcRewards[j] * weight;
+					rewardsOut[j] += contribution;
+					termProfile.Add(contribution);
+				}
+			}
 		}
 
+		// Re-used for the rewards of each function
+		std::vector<float> _funcRewards;
+
 		virtual ~CombinedReward() {
 			if (ownsFuncs)
 				for (auto func : rewardFuncs)
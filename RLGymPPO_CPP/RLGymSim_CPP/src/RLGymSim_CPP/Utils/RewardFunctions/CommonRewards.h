@@ -46,36 +46,49 @@ namespace RLGSC {
 
 		virtual void Reset(const GameState& state);
 		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction);
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevActions, bool final, float* rewardsOut) {
+			// Skipping the virtual calls is only safe if nothing overrides GetReward() or GetFinalReward()
+			bool exactType = typeid(*this) == typeid(EventReward);
+			for (int i = 0; i < state.players.size(); i++) {
+				if (exactType && !final) {
+					rewardsOut[i] = EventReward::GetReward(state.players[i], state, prevActions[i]);
+				} else if (final) {
+					rewardsOut[i] = GetFinalReward(state.players[i], state, prevActions[i]);
+				} else {
+					rewardsOut[i] = GetReward(state.players[i], state, prevActions[i]);
+				}
+			}
+		}
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/misc_rewards.py
-	class VelocityReward : public RewardFunction {
+	class VelocityReward : public PlayerRewardFunction<VelocityReward> {
 	public:
 		bool isNegative;
 		VelocityReward(bool isNegative = false) : isNegative(isNegative) {}
-		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
+		float Eval(const PlayerData& player, const GameState& state) const {
 			return player.phys.vel.Length() / CommonValues::CAR_MAX_SPEED * (1 - 2 * isNegative);
 		}
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/misc_rewards.py
-	class SaveBoostReward : public RewardFunction {
+	class SaveBoostReward : public PlayerRewardFunction<SaveBoostReward> {
 	public:
 		float exponent;
 		SaveBoostReward(float exponent = 0.5f) : exponent(exponent) {}
 
-		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
+		float Eval(const PlayerData& player, const GameState& state) const {
 			return RS_CLAMP(powf(player.boostFraction, exponent), 0, 1);
 		}
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/ball_goal_rewards.py
-	class VelocityBallToGoalReward : public RewardFunction {
+	class VelocityBallToGoalReward : public PlayerRewardFunction<VelocityBallToGoalReward> {
 	public:
 		bool ownGoal = false;
 		VelocityBallToGoalReward(bool ownGoal = false) : ownGoal(ownGoal) {}
 
-		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
+		float Eval(const PlayerData& player, const GameState& state) const {
 			bool targetOrangeGoal = player.team == Team::BLUE;
 			if (ownGoal)
 				targetOrangeGoal = !targetOrangeGoal;
@@ -88,9 +101,9 @@ namespace RLGSC {
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/player_ball_rewards.py
-	class VelocityPlayerToBallReward : public RewardFunction {
+	class VelocityPlayerToBallReward : public PlayerRewardFunction<VelocityPlayerToBallReward> {
 	public:
-		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
+		float Eval(const PlayerData& player, const GameState& state) const {
 			Vec dirToBall = (state.ball.pos - player.phys.pos).Normalized();
 			Vec normVel = player.phys.vel / CommonValues::CAR_MAX_SPEED;
 			return dirToBall.Dot(normVel);
@@ -98,21 +111,21 @@ namespace RLGSC {
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/player_ball_rewards.py
-	class FaceBallReward : public RewardFunction {
+	class FaceBallReward : public PlayerRewardFunction<FaceBallReward> {
 	public:
-		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
+		float Eval(const PlayerData& player, const GameState& state) const {
 			Vec dirToBall = (state.ball.pos - player.phys.pos).Normalized();
 			return player.carState.rotMat.forward.Dot(dirToBall);
 		}
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/common_rewards/player_ball_rewards.py
-	class TouchBallReward : public RewardFunction {
+	class TouchBallReward : public PlayerRewardFunction<TouchBallReward> {
 	public:
 		float aerialWeight;
 		TouchBallReward(float aerialWeight = 0) : aerialWeight(aerialWeight) {}
 
-		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
+		float Eval(const PlayerData& player, const GameState& state) const {
 			using namespace CommonValues;
 
 			if (player.ballTouchedStep) {
@@ -34,6 +34,50 @@ namespace RLGSC {
 			return rewards;
 		}
 
+		// Writes the rewards of all players to "rewardsOut" (one for each player in state.players)
+		// The default just copies from GetAllRewards(), rewards can override this to avoid allocating a new vector each step
+		// NOTE: Rewards that override this should also make GetAllRewards() use it, so both give the same result
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevActions, bool final, float* rewardsOut) {
+			std::vector<float> rewards = GetAllRewards(state, prevActions, final);
+			std::copy(rewards.begin(), rewards.end(), rewardsOut);
+		}
+
 		virtual ~RewardFunction() {};
 	};
+
+	// Base for stateless rewards that only depend on the player and state
+	// "T" must have a non-virtual "float Eval(const PlayerData& player, const GameState& state) const",
+	//	which is then called for every player in one loop, instead of through a virtual call for each player
+	// Subclasses of T that override GetReward() or GetFinalReward() still work, they just don't get the single loop (nor do final steps)
+	template <typename T>
+	class PlayerRewardFunction : public RewardFunction {
+	public:
+		virtual float GetReward(const PlayerData& player, const GameState& state, const Action& prevAction) {
+			return static_cast<const T*>(this)->Eval(player, state);
+		}
+
+		virtual std::vector<float> GetAllRewards(const GameState& state, const ActionSet& prevActions, bool final) {
+			std::vector<float> rewards = std::vector<float>(state.players.size());
+			PlayerRewardFunction::GetAllRewardsInto(state, prevActions, final, rewards.data());
+			return rewards;
+		}
+
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevActions, bool final, float* rewardsOut) {
+			// Eval() isn't virtual, so it would skip the overrides of a subclass of T, and any GetFinalReward()
+			if (final || typeid(*this) != typeid(T)) {
+				for (int i = 0; i < state.players.size(); i++) {
+					if (final) {
+						rewardsOut[i] = GetFinalReward(state.players[i], state, prevActions[i]);
+					} else {
+						rewardsOut[i] = GetReward(state.players[i], state, prevActions[i]);
+					}
+				}
+				return;
+			}
+
+			const T* self = static_cast<const T*>(this);
+			for (int i = 0; i < state.players.size(); i++)
+				rewardsOut[i] = self->Eval(state.players[i], state);
+		}
+	};
 }
\ No newline at end of file
@@ -35,5 +35,6 @@ namespace RLGSC {
 
 		// Get all rewards for all players
 		virtual std::vector<float> GetAllRewards(const GameState& state, const ActionSet& prevActions, bool final);
+		virtual void GetAllRewardsInto(const GameState& state, const ActionSet& prevActions, bool final, float* rewardsOut);
 	};
 }
\ No newline at end of file
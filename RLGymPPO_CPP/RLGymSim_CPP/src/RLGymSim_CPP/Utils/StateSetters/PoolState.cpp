@@ -0,0 +1,248 @@
+#include "PoolState.h"
+#include "RandomState.h"
+#include "../CommonValues.h"
+#include "../Gamestates/PhysObj.h"
+
+#include <thread>
+
+using namespace RLGSC;
+
+// Rejects spawns with cars inside each other or the ball
+bool _IsSeparated(Arena* arena, float carRadius) {
+	Vec ballPos = arena->ball->_internalState.pos;
+	for (int i = 0; i < arena->_cars.size(); i++) {
+		Vec carPos = arena->_cars[i]->_internalState.pos;
+		if (carPos.Dist(ballPos) < carRadius + CommonValues::BALL_RADIUS)
+			return false;
+
+		for (int j = i + 1; j < arena->_cars.size(); j++)
+			if (carPos.Dist(arena->_cars[j]->_internalState.pos) < carRadius * 2)
+				return false;
+	}
+
+	return true;
+}
+
+// Rejects settled states that would end the episode right away, or that left the field
+bool _IsValidSettled(Arena* arena) {
+	if (arena->IsBallScored())
+		return false;
+
+	auto fnInField = [](Vec pos) {
+		return abs(pos.x) < CommonValues::SIDE_WALL_X && abs(pos.y) < CommonValues::BACK_WALL_Y && pos.z > 0 && pos.z < CommonValues::CEILING_Z;
+	};
+
+	if (!fnInField(arena->ball->_internalState.pos))
+		return false;
+
+	for (Car* car : arena->_cars) {
+		const CarState& state = car->_internalState;
+		if (state.isDemoed || !fnInField(state.pos))
+			return false;
+	}
+
+	return true;
+}
+
+void _GenerateEntries(int blueCount, int orangeCount, const StatePoolConfig& config, StatePool::Entry* out, int amount, std::atomic<uint64_t>* rejectedOut) {
+	constexpr const char* ERR_PREFIX = "StatePool::Generate(): ";
+
+	Arena* arena = Arena::Create(config.gameMode);
+	for (int i = 0; i < blueCount; i++)
+		arena->AddCar(Team::BLUE, config.carConfig);
+	for (int i = 0; i < orangeCount; i++)
+		arena->AddCar(Team::ORANGE, config.carConfig);
+
+	RandomState randomState = RandomState(config.randBallSpeed, config.randCarSpeed, config.carsOnGround);
+	float carRadius = config.carConfig.hitboxSize.Length() / 2;
+	int controlTicks = RS_MAX(config.settleControlTicks, 1);
+
+	uint64_t rejected = 0;
+	for (int i = 0; i < amount;) {
+		if (rejected > (uint64_t)RS_MAX(amount, 100) * 1000)
+			RG_ERR_CLOSE(ERR_PREFIX << "Too many states were rejected (" << rejected << "), the config can't produce valid states");
+
+		randomState.ResetState(arena);
+		if (!_IsSeparated(arena, carRadius)) {
+			rejected++;
+			continue;
+		}
+
+		for (int tick = 0; tick < config.settleTicks; tick += controlTicks) {
+			for (Car* car : arena->_cars) {
+				CarControls controls = {};
+				controls.throttle = ::Math::RandFloat(-1, 1);
+				controls.steer = ::Math::RandFloat(-1, 1);
+				controls.pitch = ::Math::RandFloat(-1, 1);
+				controls.yaw = ::Math::RandFloat(-1, 1);
+				controls.roll = ::Math::RandFloat(-1, 1);
+				controls.boost = ::Math::RandInt(0, 2);
+				controls.handbrake = ::Math::RandInt(0, 2);
+				car->controls = controls;
+			}
+			arena->Step(RS_MIN(controlTicks, config.settleTicks - tick));
+		}
+
+		if (!_IsValidSettled(arena)) {
+			rejected++;
+			continue;
+		}
+
+		StatePool::Entry& entry = out[i];
+		entry.ball = arena->ball->GetState();
+		entry.blueCars.clear();
+		entry.orangeCars.clear();
+		for (Car* car : arena->_cars)
+			(car->team == Team::BLUE ? entry.blueCars : entry.orangeCars).push_back(car->GetState());
+		i++;
+	}
+
+	*rejectedOut += rejected;
+	delete arena;
+}
+
+StatePool StatePool::Generate(int blueCount, int orangeCount, const StatePoolConfig& config) {
+	RG_ASSERT(blueCount >= 0 && orangeCount >= 0 && config.size > 0);
+
+	StatePool result = {};
+	result.blueCount = blueCount;
+	result.orangeCount = orangeCount;
+	result.entries.resize(config.size);
+
+	int numThreads = config.numThreads > 0 ? config.numThreads : (int)std::thread::hardware_concurrency();
+	numThreads = RS_CLAMP(numThreads, 1, config.size);
+
+	std::atomic<uint64_t> rejected = 0;
+	std::vector<std::thread> threads;
+	int start = 0;
+	for (int i = 0; i < numThreads; i++) {
+		int amount = (config.size / numThreads) + (i < (config.size % numThreads));
+		threads.push_back(
+			std::thread(_GenerateEntries, blueCount, orangeCount, config, result.entries.data() + start, amount, &rejected)
+		);
+		start += amount;
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	RG_LOG("StatePool::Generate(): Generated " << config.size << " states (" << rejected << " rejected) with " << numThreads << " thread(s)");
+	return result;
+}
+
+void StatePool::Save(std::filesystem::path path) const {
+	DataStreamOut out = {};
+	out.Write<int32_t>(blueCount);
+	out.Write<int32_t>(orangeCount);
+	out.Write<uint32_t>(entries.size());
+
+	for (const Entry& entry : entries) {
+		BallState ball = entry.ball;
+		ball.Serialize(out);
+		for (const CarState& car : entry.blueCars)
+			car.Serialize(out);
+		for (const CarState& car : entry.orangeCars)
+			car.Serialize(out);
+	}
+
+	out.WriteToFile(path, true);
+}
+
+StatePool StatePool::Load(std::filesystem::path path) {
+	constexpr const char* ERR_PREFIX = "StatePool::Load(): ";
+
+	DataStreamIn in = DataStreamIn(path, true);
+
+	StatePool result = {};
+	result.blueCount = in.Read<int32_t>();
+	result.orangeCount = in.Read<int32_t>();
+	uint32_t numEntries = in.Read<uint32_t>();
+	if (in.IsOverflown() || result.blueCount < 0 || result.orangeCount < 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "Invalid state pool file " << path);
+
+	result.entries.resize(numEntries);
+	for (Entry& entry : result.entries) {
+		entry.ball.Deserialize(in);
+		entry.blueCars.resize(result.blueCount);
+		entry.orangeCars.resize(result.orangeCount);
+		for (CarState& car : entry.blueCars)
+			car.Deserialize(in);
+		for (CarState& car : entry.orangeCars)
+			car.Deserialize(in);
+	}
+
+	if (in.IsOverflown())
+		RG_ERR_CLOSE(ERR_PREFIX << "State pool file " << path << " is truncated");
+
+	return result;
+}
+
+PoolState::PoolState(std::shared_ptr<const StatePool> pool, bool mirror, bool swapTeams) :
+	pool(pool), mirror(mirror), swapTeams(swapTeams) {
+
+	RG_ASSERT(pool && !pool->entries.empty());
+}
+
+template <typename T>
+void _AugmentPhys(T& state, bool mirror, bool swapTeams) {
+	PhysObj obj = PhysObj(state);
+	if (mirror)
+		obj = obj.MirrorX();
+	if (swapTeams)
+		obj = obj.Invert();
+
+	state.pos = obj.pos;
+	state.rotMat = obj.rotMat;
+	state.vel = obj.vel;
+	state.angVel = obj.angVel;
+}
+
+GameState PoolState::ResetState(Arena* arena) {
+	constexpr const char* ERR_PREFIX = "PoolState::ResetState(): ";
+
+	int arenaBlueCount = 0;
+	for (Car* car : arena->_cars)
+		arenaBlueCount += car->team == Team::BLUE;
+	int arenaOrangeCount = arena->_cars.size() - arenaBlueCount;
+
+	if (arenaBlueCount != pool->blueCount || arenaOrangeCount != pool->orangeCount) {
+		RG_ERR_CLOSE(
+			ERR_PREFIX << "Arena has " << arenaBlueCount << " blue and " << arenaOrangeCount << " orange cars, "
+			"but the pool was made for " << pool->blueCount << " blue and " << pool->orangeCount
+		);
+	}
+
+	const StatePool::Entry& entry = pool->entries[::Math::RandInt(0, pool->entries.size())];
+	bool doMirror = mirror && ::Math::RandInt(0, 2);
+	bool doSwap = swapTeams && pool->blueCount == pool->orangeCount && ::Math::RandInt(0, 2);
+
+	BallState ballState = entry.ball;
+	_AugmentPhys(ballState, doMirror, doSwap);
+	arena->ball->SetState(ballState);
+
+	int blueIndex = 0, orangeIndex = 0;
+	for (Car* car : arena->_cars) {
+		bool isBlue = car->team == Team::BLUE;
+		const auto& sourceCars = (isBlue != doSwap) ? entry.blueCars : entry.orangeCars;
+		CarState carState = sourceCars[isBlue ? blueIndex++ : orangeIndex++];
+
+		_AugmentPhys(carState, doMirror, doSwap);
+		if (doMirror) {
+			// Relative to the car, so only the mirror changes it
+			carState.flipRelTorque *= Vec(-1, 1, -1);
+			carState.worldContact.contactNormal.x *= -1;
+		}
+		if (doSwap)
+			carState.worldContact.contactNormal *= Vec(-1, -1, 1);
+
+		// These refer to cars and controls from when the pool was generated
+		carState.ballHitInfo = {};
+		carState.carContact = {};
+		carState.lastControls = {};
+
+		car->SetState(carState);
+		car->controls = {};
+	}
+
+	return GameState(arena);
+}
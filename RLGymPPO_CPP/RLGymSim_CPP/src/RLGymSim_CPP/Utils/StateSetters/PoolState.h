@@ -0,0 +1,63 @@
+#pragma once
+#include "StateSetter.h"
+
+namespace RLGSC {
+	// See StatePool::Generate()
+	struct StatePoolConfig {
+		int size = 10'000;
+
+		GameMode gameMode = GameMode::SOCCAR;
+		CarConfig carConfig = CAR_CONFIG_OCTANE;
+
+		// Passed to RandomState
+		bool randBallSpeed = true, randCarSpeed = true, carsOnGround = false;
+
+		// Ticks to simulate each state for before it is added
+		int settleTicks = 60;
+
+		// Random controls are held for this many ticks at a time while settling
+		int settleControlTicks = 8;
+
+		// If 0, uses all hardware threads
+		int numThreads = 0;
+	};
+
+	// A large set of pre-simulated, valid start states for a fixed amount of players
+	// Start states come from RandomState, are rejected if anything spawned overlapping, then simulated for a bit with random controls so they settle
+	// A pool can be shared by many PoolStates (e.g. one per env)
+	class StatePool {
+	public:
+		struct Entry {
+			BallState ball;
+			std::vector<CarState> blueCars, orangeCars;
+		};
+
+		int blueCount = 0, orangeCount = 0;
+		std::vector<Entry> entries;
+
+		StatePool() = default;
+
+		// Simulates the states in parallel
+		static StatePool Generate(int blueCount, int orangeCount, const StatePoolConfig& config = {});
+
+		void Save(std::filesystem::path path) const;
+		static StatePool Load(std::filesystem::path path);
+	};
+
+	class PoolState : public StateSetter {
+	public:
+		std::shared_ptr<const StatePool> pool;
+
+		// Randomly mirror states along the X axis
+		bool mirror;
+
+		// Randomly swap the states of the blue and orange cars (only if both teams have the same amount of players)
+		bool swapTeams;
+
+		PoolState(std::shared_ptr<const StatePool> pool, bool mirror = true, bool swapTeams = true);
+
+		// Restores a random entry of the pool, the arena must have the same amount of cars on each team as the pool
+		// NOTE: Boost pads are not part of the state, Match::ResetState() resets them anyway
+		virtual GameState ResetState(Arena* arena);
+	};
+}
@@ -0,0 +1,99 @@
+#include "ReplayState.h"
+
+using namespace RLGSC;
+
+ReplayState::ReplayState(std::shared_ptr<const ReplayFile> file, bool sequenceStartsOnly) :
+	file(file), sequenceStartsOnly(sequenceStartsOnly) {
+
+	constexpr const char* ERR_PREFIX = "ReplayState(): ";
+
+	RG_ASSERT(file);
+	if (file->numFrames == 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "Replay file has no frames");
+
+	const ReplayCar* firstCars = file->GetCars(0);
+	for (int i = 0; i < file->header.numCars; i++) {
+		if (firstCars[i].team != (uint32_t)Team::BLUE && firstCars[i].team != (uint32_t)Team::ORANGE)
+			RG_ERR_CLOSE(ERR_PREFIX << "Car " << i << " has an invalid team (" << firstCars[i].team << ")");
+		(firstCars[i].team == (uint32_t)Team::BLUE ? _blueCount : _orangeCount)++;
+	}
+
+	// ResetState() matches arena cars to recorded cars by team, so every frame needs the same teams
+	for (size_t i = 1; i < file->numFrames; i++) {
+		const ReplayCar* cars = file->GetCars(i);
+		for (int j = 0; j < file->header.numCars; j++)
+			if (cars[j].team != firstCars[j].team)
+				RG_ERR_CLOSE(ERR_PREFIX << "Car " << j << " changes team on frame " << i << ", every frame must have the same team layout");
+	}
+
+	if (sequenceStartsOnly)
+		for (size_t i = 0; i < file->numFrames; i++)
+			if (file->IsSequenceStart(i))
+				_sequenceStarts.push_back(i);
+}
+
+GameState ReplayState::ResetState(Arena* arena) {
+	constexpr const char* ERR_PREFIX = "ReplayState::ResetState(): ";
+
+	int arenaBlueCount = 0;
+	for (Car* car : arena->_cars)
+		arenaBlueCount += car->team == Team::BLUE;
+	int arenaOrangeCount = arena->_cars.size() - arenaBlueCount;
+
+	if (arenaBlueCount != _blueCount || arenaOrangeCount != _orangeCount) {
+		RG_ERR_CLOSE(
+			ERR_PREFIX << "Arena has " << arenaBlueCount << " blue and " << arenaOrangeCount << " orange cars, "
+			"but the replay file has " << _blueCount << " blue and " << _orangeCount
+		);
+	}
+
+	size_t frameIndex;
+	if (sequenceStartsOnly) {
+		frameIndex = _sequenceStarts[::Math::RandInt(0, _sequenceStarts.size())];
+	} else {
+		// RandInt() only goes up to INT_MAX
+		std::uniform_int_distribution<size_t> dist = std::uniform_int_distribution<size_t>(0, file->numFrames - 1);
+		frameIndex = dist(::Math::GetRandEngine());
+	}
+
+	const ReplayFrameHeader& frame = file->GetFrame(frameIndex);
+	const ReplayCar* cars = file->GetCars(frameIndex);
+
+	BallState ballState = {};
+	ballState.pos = Vec(frame.ballPos[0], frame.ballPos[1], frame.ballPos[2]);
+	ballState.vel = Vec(frame.ballVel[0], frame.ballVel[1], frame.ballVel[2]);
+	ballState.angVel = Vec(frame.ballAngVel[0], frame.ballAngVel[1], frame.ballAngVel[2]);
+	arena->ball->SetState(ballState);
+
+	// Next recorded car of each team
+	int nextCar[2] = { 0, 0 };
+	for (Car* car : arena->_cars) {
+		int& recordIndex = nextCar[(int)car->team];
+		while (recordIndex < file->header.numCars && cars[recordIndex].team != (uint32_t)car->team)
+			recordIndex++;
+		if (recordIndex >= file->header.numCars)
+			RG_ERR_CLOSE(ERR_PREFIX << "Frame " << frameIndex << " has too few " << (car->team == Team::BLUE ? "blue" : "orange") << " cars");
+		const ReplayCar& record = cars[recordIndex++];
+
+		CarState carState = {};
+		carState.pos = Vec(record.pos[0], record.pos[1], record.pos[2]);
+		carState.rotMat = RotMat(
+			Vec(record.forward[0], record.forward[1], record.forward[2]),
+			Vec(record.right[0], record.right[1], record.right[2]),
+			Vec(record.up[0], record.up[1], record.up[2])
+		);
+		carState.vel = Vec(record.vel[0], record.vel[1], record.vel[2]);
+		carState.angVel = Vec(record.angVel[0], record.angVel[1], record.angVel[2]);
+		carState.boost = record.boost;
+		carState.isOnGround = record.flags & RCF_ON_GROUND;
+		carState.hasJumped = record.flags & RCF_HAS_JUMPED;
+		carState.hasDoubleJumped = record.flags & RCF_HAS_DOUBLE_JUMPED;
+		carState.hasFlipped = record.flags & RCF_HAS_FLIPPED;
+
+		// Demoed cars are restored alive where they were recorded, as there is no respawn state to restore them to
+		car->SetState(carState);
+		car->controls = {};
+	}
+
+	return GameState(arena);
+}
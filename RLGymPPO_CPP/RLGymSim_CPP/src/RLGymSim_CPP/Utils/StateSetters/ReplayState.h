@@ -0,0 +1,25 @@
+#pragma once
+#include "StateSetter.h"
+#include "../Replays/ReplayFile.h"
+
+namespace RLGSC {
+	// Resets to random frames of a replay file (see ReplayFile.h)
+	// Frames are read straight from the memory-mapped file, so a reset doesn't parse or allocate anything
+	class ReplayState : public StateSetter {
+	public:
+		std::shared_ptr<const ReplayFile> file;
+
+		// Only reset to the first frame of each sequence (e.g. kickoffs)
+		bool sequenceStartsOnly;
+
+		ReplayState(std::shared_ptr<const ReplayFile> file, bool sequenceStartsOnly = false);
+
+		// The arena must have the same amount of cars on each team as the file
+		// Recorded cars are given to the arena's cars of the same team, in order
+		virtual GameState ResetState(Arena* arena);
+
+	private:
+		int _blueCount = 0, _orangeCount = 0;
+		std::vector<size_t> _sequenceStarts;
+	};
+}
@@ -263,11 +263,7 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
 
             if (this->device.is_cpu()) {
 
-                if (!this->minibatchThreadPool) {
-                    int numThreads = std::thread::hardware_concurrency();
-                    numThreads += numThreads / 2; // Slightly faster
-                    this->minibatchThreadPool = new ThreadPool(numThreads);
-                }
+                _GetMinibatchThreadPool();
 
                 // Use multithreaded PPO learn
                 int realMinibatchSize = config.batchSize / this->minibatchThreadPool->threads.size();
@@ -377,6 +373,98 @@ void RLGPC::PPOLearner::Learn(ExperienceBuffer* expBuffer, Report& report) {
     valueOptimizer->zero_grad();
 }
 
+RLGPC::ThreadPool* RLGPC::PPOLearner::_GetMinibatchThreadPool() {
+    if (!minibatchThreadPool) {
+        int numThreads = config.learnThreads;
+        if (numThreads <= 0) {
+            numThreads = std::thread::hardware_concurrency();
+            numThreads += numThreads / 2; // Slightly faster
+        }
+        minibatchThreadPool = new ThreadPool(numThreads);
+    }
+
+    return minibatchThreadPool;
+}
+
+void RLGPC::PPOLearner::LearnSupervised(torch::Tensor obs, torch::Tensor actions, torch::Tensor targetReturns, Report& report) {
+    int64_t batchSize = obs.size(0);
+    bool trainCritic = targetReturns.defined() && config.criticLR != 0;
+
+    actions = actions.view({ batchSize, 1 }).to(kInt64);
+    if (trainCritic)
+        targetReturns = targetReturns.view({ batchSize });
+
+    policyOptimizer->zero_grad();
+    valueOptimizer->zero_grad();
+
+    std::mutex reportMutex;
+    auto fnRunMinibatch = [&](int64_t start, int64_t stop) {
+        float batchSizeRatio = (stop - start) / static_cast<float>(batchSize);
+
+        auto mbObs = obs.slice(0, start, stop).to(device, true, true);
+        auto mbActs = actions.slice(0, start, stop).to(device, true, true);
+
+        // Cross-entropy with the dataset's actions
+        auto probs = policy->GetActionProbs(mbObs);
+        auto actLogProbs = torch::log(probs).gather(-1, mbActs);
+        auto policyLoss = -actLogProbs.mean();
+        (policyLoss * batchSizeRatio).backward();
+
+        float accuracy;
+        {
+            RG_NOGRAD;
+            accuracy = (probs.argmax(-1) == mbActs.view({ -1 })).to(kFloat).mean().cpu().item<float>();
+        }
+
+        float valueLossVal = 0;
+        if (trainCritic) {
+            auto mbReturns = targetReturns.slice(0, start, stop).to(device, true, true);
+            auto vals = valueNet->Forward(mbObs).view_as(mbReturns);
+            auto valueLoss = valueLossFn(vals, mbReturns);
+            (valueLoss * batchSizeRatio).backward();
+            valueLossVal = valueLoss.detach().cpu().item<float>();
+        }
+
+        std::lock_guard<std::mutex> lock(reportMutex);
+        report.AccumAvg("BC Policy Loss", policyLoss.detach().cpu().item<float>());
+        report.AccumAvg("BC Accuracy", accuracy);
+        if (trainCritic)
+            report.AccumAvg("BC Value Loss", valueLossVal);
+    };
+
+    if (device.is_cpu()) {
+        // Split between the same threads as PPO learning
+        ThreadPool* threadPool = _GetMinibatchThreadPool();
+        int64_t realMinibatchSize = RS_MAX(batchSize / (int64_t)threadPool->threads.size(), 1);
+
+        for (int64_t start = 0; start < batchSize; start += realMinibatchSize)
+            threadPool->StartJob(std::bind(fnRunMinibatch, start, RS_MIN(start + realMinibatchSize, batchSize)));
+
+        threadPool->WaitForJobs();
+    } else {
+        int64_t miniBatchSize = RS_MAX(config.miniBatchSize, 1);
+        for (int64_t start = 0; start < batchSize; start += miniBatchSize)
+            fnRunMinibatch(start, RS_MIN(start + miniBatchSize, batchSize));
+    }
+
+    nn::utils::clip_grad_norm_(policy->parameters(), 0.5f);
+    policyOptimizer->step();
+
+    if (trainCritic) {
+        nn::utils::clip_grad_norm_(valueNet->parameters(), 0.5f);
+        valueOptimizer->step();
+    }
+
+    if (policyHalf)
+        _CopyModelParamsHalf(policy, policyHalf);
+    if (valueNetHalf)
+        _CopyModelParamsHalf(valueNet, valueNetHalf);
+
+    policyOptimizer->zero_grad();
+    valueOptimizer->zero_grad();
+    cumulativeModelUpdates++;
+}
+
 // Get sizes of all parameters in a sequence
 std::vector<uint64_t> GetSeqSizes(torch::nn::Sequential& seq) {
     std::vector<uint64_t> result;
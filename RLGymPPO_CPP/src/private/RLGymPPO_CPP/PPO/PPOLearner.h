@@ -43,10 +43,18 @@ namespace RLGPC {
 
         void Learn(ExperienceBuffer* expBuffer, Report& report);
 
+        // One supervised update on a batch of (obs, action index) samples (behaviour cloning), with cross-entropy policy loss
+        // If targetReturns is defined, the critic is also trained on them
+        // Losses and accuracy are accumulated into the report with Report::AccumAvg()
+        void LearnSupervised(torch::Tensor obs, torch::Tensor actions, torch::Tensor targetReturns, Report& report);
+
         void SaveTo(std::filesystem::path folderPath);
         void LoadFrom(std::filesystem::path folderPath);
         RLGPC::DiscretePolicy* LoadAdditionalPolicy(std::filesystem::path folderPath);
 
         void UpdateLearningRates(float policyLR, float criticLR);
+
+        // Creates the CPU minibatch thread pool on first use
+        ThreadPool* _GetMinibatchThreadPool();
     };
 }
@@ -0,0 +1,471 @@
+#include "CollectionWorkers.h"
+#include <chrono>
+
+using namespace RLGPC;
+
+constexpr size_t _Align8(size_t size) {
+	return (size + 7) & ~(size_t)7;
+}
+
+// OBS stats are stored as the sample count, then the running means and variances
+constexpr size_t _GetOBSStatsBytes(int obsStatsSize) {
+	return obsStatsSize > 0 ? (sizeof(int64_t) + sizeof(double) * 2 * obsStatsSize) : 0;
+}
+
+void _WriteOBSStats(byte* out, const WelfordRunningStat& stats) {
+	memcpy(out, &stats.count, sizeof(int64_t));
+	out += sizeof(int64_t);
+	memcpy(out, stats.runningMean.data(), sizeof(double) * stats.shape);
+	out += sizeof(double) * stats.shape;
+	memcpy(out, stats.runningVariance.data(), sizeof(double) * stats.shape);
+}
+
+void _ReadOBSStats(const byte* in, WelfordRunningStat& stats) {
+	memcpy(&stats.count, in, sizeof(int64_t));
+	in += sizeof(int64_t);
+	memcpy(stats.runningMean.data(), in, sizeof(double) * stats.shape);
+	in += sizeof(double) * stats.shape;
+	memcpy(stats.runningVariance.data(), in, sizeof(double) * stats.shape);
+}
+
+std::string _GetRingName(const std::string& name, int workerIndex) {
+	return name + "_" + std::to_string(workerIndex);
+}
+
+void _SleepMS(int ms) {
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// How often heartbeats are updated
+constexpr int HEARTBEAT_INTERVAL_MS = 100;
+
+uint64_t RLGPC::CollectionHeartbeatTime() {
+	// steady_clock is the system-wide monotonic clock on both Linux and Windows
+	using namespace std::chrono;
+	return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/////////////////////////////////////////
+
+CollectionWorkerServer::CollectionWorkerServer(
+	std::string name, int numWorkers, int numSlots, int slotSteps, int obsSize, uint64_t numParams, bool standardizeOBS, double timeout) :
+	name(name), numWorkers(numWorkers), obsStatsSize(standardizeOBS ? obsSize : 0), numParams(numParams), timeout(timeout) {
+
+	constexpr const char* ERR_PREFIX = "CollectionWorkerServer(): ";
+
+	if (numWorkers <= 0 || numSlots <= 0 || slotSteps <= 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "Invalid worker count (" << numWorkers << "), slot count (" << numSlots << "), or slot steps (" << slotSteps << ")");
+
+	size_t obsStatsBytes = _GetOBSStatsBytes(obsStatsSize);
+
+	{
+		size_t policyMemSize = _Align8(sizeof(CollectionPolicyHeader)) + _Align8(sizeof(float) * numParams) + obsStatsBytes;
+		_policyMem = SharedMemory::Create(name, policyMemSize);
+
+		auto& header = _GetPolicyHeader();
+		header.numWorkers = numWorkers;
+		header.obsStatsSize = obsStatsSize;
+		header.numParams = numParams;
+		header.heartbeat = CollectionHeartbeatTime();
+	}
+
+	// Two observations (state and next state), plus plenty of room for the other single-value tensors
+	size_t maxRowBytes = sizeof(float) * obsSize * 2 + 64;
+	size_t slotSize = _Align8(
+		sizeof(CollectionChunkHeader) + obsStatsBytes +
+		(sizeof(CollectionTensorHeader) + 8) * TrajectoryTensors::TENSOR_AMOUNT + maxRowBytes * slotSteps
+	);
+
+	for (int i = 0; i < numWorkers; i++) {
+		_ringMems.push_back(SharedMemory::Create(_GetRingName(name, i), _Align8(sizeof(CollectionRingHeader)) + slotSize * numSlots));
+
+		auto& ringHeader = _GetRingHeader(i);
+		ringHeader.numSlots = numSlots;
+		ringHeader.obsStatsSize = obsStatsSize;
+		ringHeader.slotSize = slotSize;
+		ringHeader.magic = COLLECTION_SHM_MAGIC;
+		ringHeader.version = COLLECTION_SHM_VERSION;
+	}
+
+	_attachCounts.resize(numWorkers);
+	_workersAlive.resize(numWorkers);
+
+	// Written last, so workers never see a partially set up learner
+	_GetPolicyHeader().version = COLLECTION_SHM_VERSION;
+	std::atomic_thread_fence(std::memory_order_release);
+	_GetPolicyHeader().magic = COLLECTION_SHM_MAGIC;
+
+	// Learning iterations can take a while, so heartbeats get their own thread
+	_heartbeatThread = std::thread([this]() {
+		while (_shouldRun) {
+			_GetPolicyHeader().heartbeat = CollectionHeartbeatTime();
+			_SleepMS(HEARTBEAT_INTERVAL_MS);
+		}
+	});
+
+	RG_LOG("Waiting for up to " << numWorkers << " collection worker(s) on shared memory \"" << name << "\"");
+}
+
+CollectionWorkerServer::~CollectionWorkerServer() {
+	_shouldRun = false;
+	if (_heartbeatThread.joinable())
+		_heartbeatThread.join();
+
+	// Workers see the learner timing out, even if they still have the memory mapped
+	_GetPolicyHeader().heartbeat = 0;
+
+	for (auto ringMem : _ringMems)
+		delete ringMem;
+	delete _policyMem;
+}
+
+void CollectionWorkerServer::PublishPolicy(DiscretePolicy* policy, const WelfordRunningStat* obsStats) {
+	RG_NOGRAD;
+	constexpr const char* ERR_PREFIX = "CollectionWorkerServer::PublishPolicy(): ";
+
+	// Copy everything off of the device first, so the sequence lock is held for as little time as possible
+	std::vector<torch::Tensor> params;
+	uint64_t totalParams = 0;
+	for (auto& param : policy->parameters()) {
+		params.push_back(param.detach().to(torch::kCPU, torch::kFloat32).contiguous());
+		totalParams += param.numel();
+	}
+
+	if (totalParams != numParams)
+		RG_ERR_CLOSE(ERR_PREFIX << "Policy has " << totalParams << " parameters, expected " << numParams);
+
+	auto& header = _GetPolicyHeader();
+	uint64_t seq = header.seq.load(std::memory_order_relaxed);
+	header.seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	byte* out = _policyMem->data + _Align8(sizeof(CollectionPolicyHeader));
+	for (auto& param : params) {
+		memcpy(out, param.data_ptr<float>(), sizeof(float) * param.numel());
+		out += sizeof(float) * param.numel();
+	}
+
+	if (obsStatsSize > 0) {
+		RG_ASSERT(obsStats && obsStats->shape == obsStatsSize);
+		_WriteOBSStats(_policyMem->data + _Align8(sizeof(CollectionPolicyHeader)) + _Align8(sizeof(float) * numParams), *obsStats);
+	}
+
+	header.seq.store(seq + 2, std::memory_order_release);
+	policyVersion = (seq + 2) / 2;
+}
+
+void CollectionWorkerServer::_UpdateWorkerStatus() {
+	uint64_t curTime = CollectionHeartbeatTime();
+	for (int i = 0; i < numWorkers; i++) {
+		auto& ringHeader = _GetRingHeader(i);
+
+		uint64_t attachCount = ringHeader.attachCount.load();
+		if (attachCount != _attachCounts[i]) {
+			RG_LOG("Collection worker " << i << (_attachCounts[i] > 0 ? " re-attached" : " attached"));
+			_attachCounts[i] = attachCount;
+		}
+
+		uint64_t heartbeat = ringHeader.heartbeat.load();
+		bool alive = heartbeat > 0 && (curTime - RS_MIN(heartbeat, curTime)) < timeout * 1000;
+		if (_workersAlive[i] && !alive)
+			RG_LOG("Collection worker " << i << " timed out, waiting for it to restart");
+		_workersAlive[i] = alive;
+	}
+}
+
+uint64_t CollectionWorkerServer::Receive(std::vector<GameTrajectory>& trajsOut, WelfordRunningStat* obsStatsOut) {
+	constexpr const char* ERR_PREFIX = "CollectionWorkerServer::Receive(): ";
+
+	_UpdateWorkerStatus();
+
+	uint64_t totalSteps = 0;
+	WelfordRunningStat chunkObsStats = WelfordRunningStat(obsStatsSize);
+	for (int i = 0; i < numWorkers; i++) {
+		auto& ringHeader = _GetRingHeader(i);
+		byte* slots = _ringMems[i]->data + _Align8(sizeof(CollectionRingHeader));
+
+		// Chunks from a worker that crashed are still complete, as the write count is only increased once a chunk is fully written
+		uint64_t writeCount = ringHeader.writeCount.load(std::memory_order_acquire);
+		uint64_t readCount = ringHeader.readCount.load(std::memory_order_relaxed);
+		for (; readCount < writeCount; readCount++) {
+			const byte* in = slots + (readCount % ringHeader.numSlots) * ringHeader.slotSize;
+
+			CollectionChunkHeader chunkHeader;
+			memcpy(&chunkHeader, in, sizeof(chunkHeader));
+			if (chunkHeader.byteSize > ringHeader.slotSize)
+				RG_ERR_CLOSE(ERR_PREFIX << "Chunk from worker " << i << " is larger than its slot (" << chunkHeader.byteSize << " > " << ringHeader.slotSize << ")");
+			in += sizeof(chunkHeader);
+
+			if (obsStatsSize > 0) {
+				_ReadOBSStats(in, chunkObsStats);
+				if (obsStatsOut)
+					obsStatsOut->Merge(chunkObsStats);
+				in += _GetOBSStatsBytes(obsStatsSize);
+			}
+
+			// A worker can't be ahead of us, but its version could be from before a learner restart
+			uint64_t lag = policyVersion - RS_MIN(chunkHeader.policyVersion, policyVersion);
+			lagStats.numChunks++;
+			lagStats.totalLag += lag;
+			lagStats.maxLag = RS_MAX(lagStats.maxLag, lag);
+
+			if (maxPolicyLag >= 0 && lag > (uint64_t)maxPolicyLag) {
+				lagStats.numDroppedChunks++;
+				lagStats.numDroppedSteps += chunkHeader.numSteps;
+				ringHeader.readCount.store(readCount + 1, std::memory_order_release);
+				continue;
+			}
+
+			GameTrajectory traj;
+			int64_t numSteps = chunkHeader.numSteps;
+			for (auto& tensor : traj.data) {
+				CollectionTensorHeader tensorHeader;
+				memcpy(&tensorHeader, in, sizeof(tensorHeader));
+				in += sizeof(tensorHeader);
+
+				auto options = torch::TensorOptions().dtype((c10::ScalarType)tensorHeader.scalarType);
+				if (tensorHeader.rowDims == 0) {
+					tensor = torch::empty({ numSteps }, options);
+				} else {
+					tensor = torch::empty({ numSteps, tensorHeader.rowNumel }, options);
+				}
+
+				size_t bytes = tensor.numel() * tensor.element_size();
+				memcpy(tensor.data_ptr(), in, bytes);
+				in += _Align8(bytes);
+			}
+			traj.size = traj.capacity = numSteps;
+
+			totalSteps += numSteps;
+			trajsOut.push_back(std::move(traj));
+
+			// Only now can the worker overwrite the slot
+			ringHeader.readCount.store(readCount + 1, std::memory_order_release);
+		}
+	}
+
+	return totalSteps;
+}
+
+int CollectionWorkerServer::GetNumAliveWorkers() const {
+	int numAlive = 0;
+	for (bool alive : _workersAlive)
+		numAlive += alive;
+	return numAlive;
+}
+
+/////////////////////////////////////////
+
+CollectionWorkerClient::CollectionWorkerClient(std::string name, int workerIndex, double timeout) :
+	name(name), workerIndex(workerIndex), timeout(timeout) {
+
+	constexpr const char* ERR_PREFIX = "CollectionWorkerClient(): ";
+
+	// The learner might not have started yet, or the shared memory might be left over from a learner that crashed
+	RG_LOG("Collection worker " << workerIndex << ": Waiting for the learner on shared memory \"" << name << "\"...");
+	while (true) {
+		_policyMem = SharedMemory::Open(name);
+		if (_policyMem) {
+			auto& header = _GetPolicyHeader();
+			if (header.magic == COLLECTION_SHM_MAGIC && IsLearnerAlive())
+				break;
+
+			delete _policyMem;
+			_policyMem = NULL;
+		}
+
+		_SleepMS(HEARTBEAT_INTERVAL_MS);
+	}
+
+	auto& header = _GetPolicyHeader();
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (header.version != COLLECTION_SHM_VERSION)
+		RG_ERR_CLOSE(ERR_PREFIX << "Learner uses shared memory version " << header.version << ", expected " << COLLECTION_SHM_VERSION);
+
+	if (workerIndex < 0 || workerIndex >= header.numWorkers)
+		RG_ERR_CLOSE(ERR_PREFIX << "Worker index " << workerIndex << " is out of range, the learner accepts " << header.numWorkers << " worker(s)");
+
+	_ringMem = SharedMemory::Open(_GetRingName(name, workerIndex));
+	if (!_ringMem)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to open the shared memory of worker " << workerIndex);
+
+	auto& ringHeader = _GetRingHeader();
+	if (ringHeader.magic != COLLECTION_SHM_MAGIC)
+		RG_ERR_CLOSE(ERR_PREFIX << "Shared memory of worker " << workerIndex << " is invalid");
+
+	// Rings only have one producer, so a worker that just crashed (or is still running) has to time out first
+	bool loggedWait = false;
+	while (true) {
+		uint64_t lastHeartbeat = ringHeader.heartbeat.load();
+		uint64_t curTime = CollectionHeartbeatTime();
+		if (lastHeartbeat == 0 || (curTime - RS_MIN(lastHeartbeat, curTime)) >= HEARTBEAT_INTERVAL_MS * 10)
+			break;
+
+		if (!loggedWait) {
+			RG_LOG("Collection worker " << workerIndex << ": Waiting for the previous process using this index to time out...");
+			loggedWait = true;
+		}
+		_SleepMS(HEARTBEAT_INTERVAL_MS);
+	}
+
+	_paramsBuffer.resize(header.numParams);
+	_obsStatsBuffer.resize(_GetOBSStatsBytes(header.obsStatsSize) / sizeof(double) + 1);
+
+	ringHeader.heartbeat = CollectionHeartbeatTime();
+	ringHeader.attachCount++;
+
+	_heartbeatThread = std::thread([this]() {
+		while (_shouldRun) {
+			_GetRingHeader().heartbeat = CollectionHeartbeatTime();
+			_SleepMS(HEARTBEAT_INTERVAL_MS);
+		}
+	});
+
+	RG_LOG("Collection worker " << workerIndex << ": Attached to the learner");
+}
+
+CollectionWorkerClient::~CollectionWorkerClient() {
+	_shouldRun = false;
+	if (_heartbeatThread.joinable())
+		_heartbeatThread.join();
+
+	// Lets a replacement worker attach right away
+	_GetRingHeader().heartbeat = 0;
+
+	delete _ringMem;
+	delete _policyMem;
+}
+
+bool CollectionWorkerClient::IsLearnerAlive() const {
+	uint64_t heartbeat = _GetPolicyHeader().heartbeat.load();
+	uint64_t curTime = CollectionHeartbeatTime();
+	return heartbeat > 0 && (curTime - RS_MIN(heartbeat, curTime)) < timeout * 1000;
+}
+
+bool CollectionWorkerClient::TryReadPolicy(DiscretePolicy* policy, WelfordRunningStat* obsStatsOut) {
+	RG_NOGRAD;
+	constexpr const char* ERR_PREFIX = "CollectionWorkerClient::TryReadPolicy(): ";
+
+	auto& header = _GetPolicyHeader();
+	const byte* paramsIn = _policyMem->data + _Align8(sizeof(CollectionPolicyHeader));
+	const byte* obsStatsIn = paramsIn + _Align8(sizeof(float) * header.numParams);
+
+	// Retry until the learner didn't publish a new policy while we were copying it
+	uint64_t seq;
+	while (true) {
+		seq = header.seq.load(std::memory_order_acquire);
+		if (seq / 2 <= policyVersion)
+			return false;
+
+		if (seq % 2 == 0) {
+			memcpy(_paramsBuffer.data(), paramsIn, sizeof(float) * _paramsBuffer.size());
+			if (header.obsStatsSize > 0)
+				memcpy(_obsStatsBuffer.data(), obsStatsIn, _GetOBSStatsBytes(header.obsStatsSize));
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (header.seq.load(std::memory_order_relaxed) == seq)
+				break;
+		}
+
+		std::this_thread::yield();
+	}
+
+	uint64_t offset = 0;
+	for (auto& param : policy->parameters()) {
+		if (offset + param.numel() > _paramsBuffer.size())
+			RG_ERR_CLOSE(ERR_PREFIX << "Policy has more parameters than the learner's (" << _paramsBuffer.size() << ")");
+
+		auto paramCPU = torch::from_blob(_paramsBuffer.data() + offset, param.sizes(), torch::kFloat32);
+		param.copy_(paramCPU);
+		offset += param.numel();
+	}
+
+	if (offset != _paramsBuffer.size())
+		RG_ERR_CLOSE(ERR_PREFIX << "Policy has " << offset << " parameters, expected " << _paramsBuffer.size());
+
+	if (header.obsStatsSize > 0 && obsStatsOut) {
+		RG_ASSERT(obsStatsOut->shape == header.obsStatsSize);
+		_ReadOBSStats((const byte*)_obsStatsBuffer.data(), *obsStatsOut);
+	}
+
+	policyVersion = seq / 2;
+	return true;
+}
+
+bool CollectionWorkerClient::Send(GameTrajectory& traj, const WelfordRunningStat* newObsStats) {
+	constexpr const char* ERR_PREFIX = "CollectionWorkerClient::Send(): ";
+
+	auto& ringHeader = _GetRingHeader();
+	byte* slots = _ringMem->data + _Align8(sizeof(CollectionRingHeader));
+	size_t obsStatsBytes = _GetOBSStatsBytes(ringHeader.obsStatsSize);
+
+	traj.RemoveCapacity();
+	for (auto& tensor : traj.data)
+		tensor = tensor.cpu().contiguous();
+
+	size_t fixedBytes = sizeof(CollectionChunkHeader) + obsStatsBytes;
+	size_t rowBytes = 0;
+	for (auto& tensor : traj.data) {
+		fixedBytes += sizeof(CollectionTensorHeader) + 8;
+		rowBytes += (tensor.numel() / RS_MAX(tensor.size(0), 1)) * tensor.element_size();
+	}
+
+	if (fixedBytes + rowBytes > ringHeader.slotSize)
+		RG_ERR_CLOSE(ERR_PREFIX << "A single timestep (" << rowBytes << " bytes) does not fit in a slot (" << ringHeader.slotSize << " bytes)");
+	int64_t maxStepsPerChunk = (ringHeader.slotSize - fixedBytes) / rowBytes;
+
+	bool isFirstChunk = true;
+	for (int64_t start = 0; start < traj.size; start += maxStepsPerChunk) {
+		int64_t end = RS_MIN(start + maxStepsPerChunk, (int64_t)traj.size);
+
+		// The learner treats each chunk as its own set of trajectories, so a split trajectory is truncated there
+		if (end < traj.size && traj.data.dones[end - 1].item<float>() == 0)
+			traj.data.truncateds[end - 1] = 1;
+
+		uint64_t writeCount = ringHeader.writeCount.load(std::memory_order_relaxed);
+		while (writeCount - ringHeader.readCount.load(std::memory_order_acquire) >= ringHeader.numSlots) {
+			if (!IsLearnerAlive())
+				return false;
+			_SleepMS(1);
+		}
+
+		byte* slot = slots + (writeCount % ringHeader.numSlots) * ringHeader.slotSize;
+		byte* out = slot + sizeof(CollectionChunkHeader);
+
+		if (obsStatsBytes > 0) {
+			if (isFirstChunk && newObsStats) {
+				RG_ASSERT(newObsStats->shape == ringHeader.obsStatsSize);
+				_WriteOBSStats(out, *newObsStats);
+			} else {
+				memset(out, 0, obsStatsBytes);
+			}
+			out += obsStatsBytes;
+		}
+
+		for (auto& tensor : traj.data) {
+			torch::Tensor rows = tensor.slice(0, start, end);
+
+			CollectionTensorHeader tensorHeader = {};
+			tensorHeader.scalarType = (int32_t)tensor.scalar_type();
+			tensorHeader.rowDims = tensor.dim() - 1;
+			tensorHeader.rowNumel = tensor.numel() / RS_MAX(tensor.size(0), 1);
+			memcpy(out, &tensorHeader, sizeof(tensorHeader));
+			out += sizeof(tensorHeader);
+
+			size_t bytes = rows.numel() * rows.element_size();
+			memcpy(out, rows.data_ptr(), bytes);
+			out += _Align8(bytes);
+		}
+
+		CollectionChunkHeader chunkHeader = {};
+		chunkHeader.numSteps = end - start;
+		chunkHeader.policyVersion = policyVersion;
+		chunkHeader.byteSize = out - slot;
+		memcpy(slot, &chunkHeader, sizeof(chunkHeader));
+
+		ringHeader.writeCount.store(writeCount + 1, std::memory_order_release);
+		isFirstChunk = false;
+	}
+
+	return true;
+}
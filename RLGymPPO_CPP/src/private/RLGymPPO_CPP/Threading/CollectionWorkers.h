@@ -0,0 +1,161 @@
+#pragma once
+#include "GameTrajectory.h"
+#include "../PPO/DiscretePolicy.h"
+#include "../Util/SharedMemory.h"
+#include <RLGymPPO_CPP/Util/WelfordRunningStat.h>
+#include <thread>
+#include <atomic>
+
+// Transport between a learner and its collection worker processes, see LearnerConfig::numCollectionWorkers
+// Layout of the shared memory:
+//	"<name>": CollectionPolicyHeader, the policy parameters (floats), then the learner's OBS stats (if standardizing observations)
+//	"<name>_<worker index>": CollectionRingHeader, then a ring of numSlots chunk slots of slotSize bytes
+//	Each slot is a CollectionChunkHeader, the worker's new OBS stats (if standardizing observations),
+//	then each tensor of a GameTrajectory as a CollectionTensorHeader and its rows
+// Only the learner and each ring's worker ever write to their side, so no locks are needed:
+//	the policy is published with a sequence lock, and each ring has a single producer and a single consumer
+namespace RLGPC {
+	constexpr uint32_t COLLECTION_SHM_MAGIC = 0x43504752; // "RGPC"
+	constexpr uint32_t COLLECTION_SHM_VERSION = 1;
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "Collection workers need lock-free 64-bit atomics");
+
+	struct CollectionPolicyHeader {
+		uint32_t magic, version;
+		uint32_t numWorkers;
+		uint32_t obsStatsSize; // 0 if observations aren't standardized
+		uint64_t numParams;
+
+		// Odd while a new policy is being written, the policy version is half of this
+		std::atomic<uint64_t> seq;
+
+		// Time (in ms, see CollectionHeartbeatTime()) the learner was last known to be running
+		std::atomic<uint64_t> heartbeat;
+	};
+
+	struct CollectionRingHeader {
+		uint32_t magic, version;
+		uint32_t numSlots;
+		uint32_t obsStatsSize;
+		uint64_t slotSize;
+
+		// Chunks written by the worker and read by the learner, ever
+		std::atomic<uint64_t> writeCount, readCount;
+
+		// Time (in ms) the worker was last known to be running, 0 if it has never attached
+		std::atomic<uint64_t> heartbeat;
+
+		// Incremented each time a worker process attaches to this ring
+		std::atomic<uint64_t> attachCount;
+	};
+
+	struct CollectionChunkHeader {
+		uint64_t numSteps;
+		uint64_t policyVersion; // Policy version the worker had when it sent this chunk
+		uint64_t byteSize; // Including this header
+	};
+
+	struct CollectionTensorHeader {
+		int32_t scalarType; // c10::ScalarType
+		int32_t rowDims; // 0 for tensors of single values per step
+		int64_t rowNumel;
+	};
+
+	// Milliseconds on a clock shared by every process on the machine
+	uint64_t CollectionHeartbeatTime();
+
+	// How many policy versions behind the learner the chunks it received were, see CollectionWorkerServer::lagStats
+	struct CollectionLagStats {
+		uint64_t numChunks;
+		uint64_t totalLag, maxLag;
+		uint64_t numDroppedChunks, numDroppedSteps;
+
+		double GetAvgLag() const { return numChunks ? (double)totalLag / numChunks : 0; }
+	};
+
+	// Learner side, owns the shared memory
+	class CollectionWorkerServer {
+	public:
+		std::string name;
+		int numWorkers;
+		int obsStatsSize;
+		uint64_t numParams;
+		double timeout;
+
+		// Chunks more than this many versions behind the latest policy are dropped, -1 to keep all of them
+		int maxPolicyLag = -1;
+
+		uint64_t policyVersion = 0;
+
+		// Accumulated by Receive(), reset it yourself
+		CollectionLagStats lagStats = {};
+
+		CollectionWorkerServer(std::string name, int numWorkers, int numSlots, int slotSteps, int obsSize, uint64_t numParams, bool standardizeOBS, double timeout);
+		~CollectionWorkerServer();
+
+		RG_NO_COPY(CollectionWorkerServer);
+
+		// Makes workers switch to this policy (and these OBS stats, if standardizing observations)
+		void PublishPolicy(DiscretePolicy* policy, const WelfordRunningStat* obsStats);
+
+		// Moves every chunk workers have finished sending into trajsOut, and merges their new OBS stats into obsStatsOut (if not NULL)
+		// Chunks from too old of a policy (see maxPolicyLag) are dropped, though their OBS stats are still merged
+		// Also logs workers that timed out or (re)attached
+		// Returns the amount of timesteps received (not including dropped ones)
+		uint64_t Receive(std::vector<GameTrajectory>& trajsOut, WelfordRunningStat* obsStatsOut);
+
+		int GetNumAliveWorkers() const;
+
+	private:
+		SharedMemory* _policyMem;
+		std::vector<SharedMemory*> _ringMems;
+		std::vector<uint64_t> _attachCounts;
+		std::vector<bool> _workersAlive;
+
+		std::thread _heartbeatThread;
+		std::atomic<bool> _shouldRun = true;
+
+		CollectionPolicyHeader& _GetPolicyHeader() const { return *(CollectionPolicyHeader*)_policyMem->data; }
+		CollectionRingHeader& _GetRingHeader(int workerIndex) const { return *(CollectionRingHeader*)_ringMems[workerIndex]->data; }
+		void _UpdateWorkerStatus();
+	};
+
+	// Worker side
+	class CollectionWorkerClient {
+	public:
+		std::string name;
+		int workerIndex;
+		double timeout;
+
+		uint64_t policyVersion = 0;
+
+		// Waits until a running learner has created the shared memory
+		CollectionWorkerClient(std::string name, int workerIndex, double timeout);
+		~CollectionWorkerClient();
+
+		RG_NO_COPY(CollectionWorkerClient);
+
+		bool IsLearnerAlive() const;
+
+		// Copies the learner's latest policy into policy (and its OBS stats into obsStatsOut, if not NULL)
+		// Returns false if there is no newer policy than the last one read
+		bool TryReadPolicy(DiscretePolicy* policy, WelfordRunningStat* obsStatsOut);
+
+		// Sends timesteps to the learner, split into as many chunks as needed (each piece is truncated at the split)
+		// New OBS stats (if not NULL) are sent with the first chunk
+		// Waits for free slots, returns false if the learner stopped
+		bool Send(GameTrajectory& traj, const WelfordRunningStat* newObsStats);
+
+	private:
+		SharedMemory* _policyMem = NULL;
+		SharedMemory* _ringMem = NULL;
+		std::vector<float> _paramsBuffer;
+		std::vector<double> _obsStatsBuffer;
+
+		std::thread _heartbeatThread;
+		std::atomic<bool> _shouldRun = true;
+
+		CollectionPolicyHeader& _GetPolicyHeader() const { return *(CollectionPolicyHeader*)_policyMem->data; }
+		CollectionRingHeader& _GetRingHeader() const { return *(CollectionRingHeader*)_ringMem->data; }
+	};
+}
@@ -6,25 +6,34 @@
 
 namespace RLGPC {
 
+    // Copies the observations of all games into one tensor, without making a tensor for each game first
     torch::Tensor MakeGamesOBSTensor(const std::vector<GameInst*>& games) {
         assert(!games.empty());
-        std::vector<torch::Tensor> obsTensors;
-        obsTensors.reserve(games.size());
+        int64_t totalPlayers = 0;
         for (const auto& game : games)
-            obsTensors.push_back(FLIST2_TO_TENSOR(game->curObs));
-        try {
-            return torch::cat(obsTensors, 0);
-        }
-        catch (const std::exception& e) {
-            RG_ERR_CLOSE("Failed to concat OBS tensors: " << e.what());
-            return {};
+            totalPlayers += game->curObs.size();
+
+        int64_t obsSize = games[0]->curObs[0].size();
+        torch::Tensor result = torch::empty({ totalPlayers, obsSize });
+        float* out = result.data_ptr<float>();
+        for (const auto& game : games) {
+            for (const auto& obs : game->curObs) {
+                if (obs.size() != obsSize)
+                    RG_ERR_CLOSE("Failed to make OBS tensor: Observation size (" << obs.size() << ") does not match the first observation size (" << obsSize << ")");
+                memcpy(out, obs.data(), obsSize * sizeof(float));
+                out += obsSize;
+            }
         }
+        return result;
     }
 
     ThreadAgent::ThreadAgent(void* manager, int numGames, uint64_t maxCollect, EnvCreateFn envCreateFn, int index)
         : _manager(manager), index(index), numGames(numGames), maxCollect(maxCollect), stepsCollected(0) {
         trajectories.resize(numGames);
+        gameOpponents.resize(numGames);
         gameInsts.reserve(numGames);
+        arenaFactory = new RocketSim::ArenaFactory(numGames);
+        RocketSim::ArenaFactory::Scope arenaFactoryScope(arenaFactory);
         for (int i = 0; i < numGames; ++i) {
             auto envCreateResult = envCreateFn();
             gameInsts.push_back(new GameInst(envCreateResult.gym, envCreateResult.match));
@@ -59,7 +68,50 @@ namespace RLGPC {
         Timer stepTimer;
         for (auto& game : games)
             game->Start();
+        bool standardizeOBS = mgr->standardizeOBS;
+        OBSStandardizer::Reader obsStandardizerReader = {};
+        uint64_t obsStepCounter = 0;
+
+        // Standardizes (in-place) the raw observations of all games, sampling them for the stats every stepsPerObsStatsInc steps
+        auto fnStandardizeOBS = [&](torch::Tensor& obs) {
+            if (!standardizeOBS)
+                return;
+
+            if (obsStepCounter % mgr->stepsPerObsStatsInc == 0) {
+                obsStats.IncrementBatch(obs.data_ptr<float>(), obs.size(0));
+
+                // Hand everything sampled so far to the manager once it has taken the last batch
+                // Otherwise keep accumulating, we never wait on the manager
+                if (!obsStatsPublished.load(std::memory_order_acquire)) {
+                    std::swap(obsStats, publishedObsStats);
+                    obsStatsPublished.store(true, std::memory_order_release);
+                }
+            }
+            obsStepCounter++;
+
+            mgr->obsStandardizer->Apply(obs, obsStandardizerReader);
+        };
+
+        // Picks who controls the opponent team for the next episode of a game
+        auto fnPickOpponent = [&](int gameIdx) {
+            auto& opponent = gameOpponents[gameIdx];
+            opponent = {};
+            if (games[gameIdx]->match->spawnOpponents) {
+                opponent.policy = mgr->PickOpponent();
+                opponent.team = (RocketSim::Math::RandFloat() > 0.5f) ? RocketSim::Team::BLUE : RocketSim::Team::ORANGE;
+            }
+        };
+        for (int i = 0; i < numGames; ++i)
+            fnPickOpponent(i);
+
+        // Per observation row, the row of the learner's inference it came from (-1 for opponent rows)
+        // Only used for steps where some game has an opponent from the pool
+        std::vector<int64_t> learnerRowIndices;
+        std::vector<int64_t> learnerRows;
+        std::vector<std::pair<DiscretePolicy*, std::vector<int64_t>>> opponentRows;
+
         torch::Tensor curObsTensor = MakeGamesOBSTensor(games);
+        fnStandardizeOBS(curObsTensor);
         constexpr bool halfPrec = false;
         auto policy = (halfPrec && mgr->policyHalf) ? mgr->policyHalf : mgr->policy;
         while (shouldRun) {
@@ -69,17 +121,70 @@ namespace RLGPC {
                 std::this_thread::yield();
             while (mgr->disableCollection)
                 std::this_thread::yield();
+
+            // Group rows by the policy controlling them, so there is still only one forward per policy version
+            bool hasOpponents = false;
+            for (auto& opponent : gameOpponents)
+                hasOpponents |= (opponent.policy != nullptr);
+
+            torch::Tensor learnerObsTensor = curObsTensor;
+            if (hasOpponents) {
+                learnerRowIndices.clear();
+                learnerRows.clear();
+                opponentRows.clear();
+
+                for (int i = 0, row = 0; i < numGames; ++i) {
+                    auto& opponent = gameOpponents[i];
+                    auto& players = games[i]->gym->prevState.players;
+                    for (int j = 0; j < players.size(); ++j, ++row) {
+                        if (opponent.policy && players[j].team == opponent.team) {
+                            auto itr = std::find_if(opponentRows.begin(), opponentRows.end(),
+                                [&](const auto& pair) { return pair.first == opponent.policy.get(); });
+                            if (itr == opponentRows.end()) {
+                                opponentRows.push_back({ opponent.policy.get(), {} });
+                                itr = opponentRows.end() - 1;
+                            }
+                            itr->second.push_back(row);
+                            learnerRowIndices.push_back(-1);
+                        } else {
+                            learnerRowIndices.push_back(learnerRows.size());
+                            learnerRows.push_back(row);
+                        }
+                    }
+                }
+
+                learnerObsTensor = curObsTensor.index_select(0, torch::tensor(learnerRows));
+            }
+
             torch::Tensor curObsTensorDevice;
             if (halfPrec) {
-                curObsTensorDevice = curObsTensor.to(RG_HALFPERC_TYPE).to(device, true);
+                curObsTensorDevice = learnerObsTensor.to(RG_HALFPERC_TYPE).to(device, true);
             }
             else {
-                curObsTensorDevice = curObsTensor.to(device, true);
+                curObsTensorDevice = learnerObsTensor.to(device, true);
             }
             Timer policyInferTimer;
             if (blockConcurrentInfer)
                 mgr->inferMutex.lock();
             auto actionResults = policy->GetAction(curObsTensorDevice, deterministic);
+
+            // Actions for every row, in game order
+            torch::Tensor allActions = actionResults.action;
+            if (hasOpponents) {
+                auto learnerActions = actionResults.action.cpu();
+                allActions = torch::empty({ (int64_t)learnerRowIndices.size() }, learnerActions.options());
+                allActions.index_copy_(0, torch::tensor(learnerRows), learnerActions);
+
+                for (auto& pair : opponentRows) {
+                    if (pair.second.empty())
+                        continue;
+
+                    auto rows = torch::tensor(pair.second);
+                    auto opponentObs = curObsTensor.index_select(0, rows).to(pair.first->device, true);
+                    auto opponentActions = pair.first->GetAction(opponentObs, deterministic).action;
+                    allActions.index_copy_(0, rows, opponentActions.cpu().to(allActions.scalar_type()));
+                }
+            }
             if (blockConcurrentInfer)
                 mgr->inferMutex.unlock();
             if (halfPrec) {
@@ -96,14 +201,15 @@ namespace RLGPC {
                 for (int i = 0; i < numGames; ++i) {
                     auto& game = games[i];
                     int numPlayers = game->match->playerAmount;
-                    auto actionSlice = actionResults.action.slice(0, actionsOffset, actionsOffset + numPlayers);
+                    auto actionSlice = allActions.slice(0, actionsOffset, actionsOffset + numPlayers);
                     stepResults[i] = game->Step(TENSOR_TO_ILIST(actionSlice));
                     actionsOffset += numPlayers;
                 }
-                assert(actionsOffset == static_cast<size_t>(actionResults.action.size(0)));
+                assert(actionsOffset == static_cast<size_t>(allActions.size(0)));
                 double envStepTime = gymStepTimer.Elapsed();
                 times.envStepTime += envStepTime;
                 torch::Tensor nextObsTensor = MakeGamesOBSTensor(games);
+                fnStandardizeOBS(nextObsTensor);
                 if (!render) {
                     Timer trajAppendTimer;
                     {
@@ -115,11 +221,17 @@ namespace RLGPC {
                             float truncated = 0.0f;
                             auto tDone = torch::tensor(done);
                             auto tTruncated = torch::tensor(truncated);
+                            int numLearnerPlayers = 0;
                             for (int j = 0; j < numPlayers; ++j) {
+                                // Only the learner's players are trained on
+                                int64_t learnerRow = hasOpponents ? learnerRowIndices[playerOffset + j] : (playerOffset + j);
+                                if (learnerRow == -1)
+                                    continue;
+
                                 trajectories[i][j].AppendSingleStep({
                                     curObsTensor[playerOffset + j],
-                                    actionResults.action[playerOffset + j],
-                                    actionResults.logProb[playerOffset + j],
+                                    actionResults.action[learnerRow],
+                                    actionResults.logProb[learnerRow],
                                     torch::tensor(stepResult.reward[j]),
         #ifdef RG_PARANOID_MODE
                                     torch::Tensor(),
@@ -128,8 +240,9 @@ namespace RLGPC {
                                     tDone,
                                     tTruncated
                                     });
+                                numLearnerPlayers++;
                             }
-                            stepsCollected += numPlayers;
+                            stepsCollected += numLearnerPlayers;
                             playerOffset += numPlayers;
                         }
                     }
@@ -149,6 +262,10 @@ namespace RLGPC {
                     std::this_thread::sleep_for(microseconds(static_cast<int64_t>(sleepTime * 1e6)));
                 }
                 curObsTensor = nextObsTensor;
+
+                for (int i = 0; i < numGames; ++i)
+                    if (stepResults[i].done)
+                        fnPickOpponent(i);
             }
         }
         isRunning = false;
@@ -157,6 +274,9 @@ namespace RLGPC {
     ThreadAgent::~ThreadAgent() {
         for (auto& game : gameInsts)
             delete game;
+
+        // Must outlive the arenas
+        delete arenaFactory;
     }
 
 }
@@ -2,6 +2,7 @@
 #include "../PPO/DiscretePolicy.h"
 #include <RLGymPPO_CPP/Threading/GameInst.h>
 #include "GameTrajectory.h"
+#include <RLGymPPO_CPP/Util/WelfordRunningStat.h>
 #include <thread>
 #include <mutex>
 #include <atomic>
@@ -15,6 +16,9 @@ namespace RLGPC {
         int index;
         int numGames;
         std::vector<GameInst*> gameInsts;
+
+        // Our games all step on our thread, so their arenas can share one set of memory pools
+        RocketSim::ArenaFactory* arenaFactory;
         std::atomic<bool> shouldRun{ false };
         std::atomic<bool> isRunning{ false };
         struct Times {
@@ -26,10 +30,24 @@ namespace RLGPC {
         };
         Times times;
         std::vector<std::vector<GameTrajectory>> trajectories;
+
+        // Opponent of each game for its current episode, the policy is NULL for mirror self-play
+        struct GameOpponent {
+            std::shared_ptr<DiscretePolicy> policy;
+            RocketSim::Team team = RocketSim::Team::ORANGE;
+        };
+        std::vector<GameOpponent> gameOpponents;
         std::atomic<uint64_t> stepsCollected{ 0 };
         uint64_t maxCollect;
         std::mutex gameStepMutex;
         std::mutex trajMutex;
+
+        // Observation stats sampled by our thread that haven't been published yet, only our thread touches them
+        WelfordRunningStat obsStats;
+        // Stats handed over to the manager without locking: owned by our thread while obsStatsPublished is false,
+        //  and by the manager (which merges, resets, and gives them back in CollectTimesteps()) while it is true
+        WelfordRunningStat publishedObsStats;
+        std::atomic<bool> obsStatsPublished{ false };
         ThreadAgent(void* manager, int numGames, uint64_t maxCollect, EnvCreateFn envCreateFn, int index);
         void Start();
         void Stop();
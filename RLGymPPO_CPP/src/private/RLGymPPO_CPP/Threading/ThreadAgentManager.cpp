@@ -1,5 +1,6 @@
 #include "ThreadAgentManager.h"
 #include <RLGymPPO_CPP/Util/Timer.h>
+#include <RLGymSim_CPP/Utils/RewardFunctions/CombinedReward.h>
 #include <thread>
 
 namespace RLGPC {
@@ -11,13 +12,31 @@ namespace RLGPC {
         standardizeOBS(standardizeOBS), deterministic(deterministic),
         blockConcurrentInfer(blockConcurrentInfer), maxCollect(maxCollect), device(device) {}
 
+    void ThreadAgentManager::InitOBSStandardization(int obsSize, float clipRange, int stepsPerStatsInc) {
+        obsStats = WelfordRunningStat(obsSize);
+        delete obsStandardizer;
+        obsStandardizer = new OBSStandardizer(obsSize, clipRange);
+        stepsPerObsStatsInc = RS_MAX(stepsPerStatsInc, 1);
+    }
+
+    void ThreadAgentManager::UpdateOBSStandardization() {
+        obsStandardizer->SetStats(obsStats);
+    }
+
     void ThreadAgentManager::CreateAgents(EnvCreateFn func, int amount, int gamesPerAgent) {
+        if (standardizeOBS && !obsStandardizer)
+            RG_ERR_CLOSE("ThreadAgentManager::CreateAgents(): InitOBSStandardization() must be called first when standardizeOBS is set");
+
         for (int i = 0; i < amount; ++i) {
             int numGames = gamesPerAgent;
             if (renderSender && renderDuringTraining && i == 0) {
                 numGames = 1;
             }
             auto agent = new ThreadAgent(this, numGames, maxCollect / amount, func, i);
+            if (standardizeOBS) {
+                agent->obsStats = WelfordRunningStat(obsStats.shape);
+                agent->publishedObsStats = WelfordRunningStat(obsStats.shape);
+            }
             agents.push_back(agent);
         }
     }
@@ -42,21 +61,25 @@ namespace RLGPC {
         }
     }
 
+    uint64_t ThreadAgentManager::GetStepsCollected() {
+        uint64_t totalSteps = 0;
+        for (auto* agent : agents) {
+            totalSteps += agent->stepsCollected.load();
+        }
+        return totalSteps;
+    }
+
     GameTrajectory ThreadAgentManager::CollectTimesteps(uint64_t amount) {
-        while (true) {
-            uint64_t totalSteps = 0;
-            for (auto* agent : agents) {
-                totalSteps += agent->stepsCollected.load();
-            }
-            if (totalSteps >= amount) {
-                break;
-            }
+        while (GetStepsCollected() < amount) {
             std::this_thread::yield();
         }
 
         GameTrajectory result;
         size_t totalTimesteps = 0;
 
+        if (standardizeOBS)
+            lastCollectedObsStats = WelfordRunningStat(obsStats.shape);
+
         try {
             std::vector<GameTrajectory> trajs;
             for (auto* agent : agents) {
@@ -74,7 +97,23 @@ namespace RLGPC {
                 agent->stepsCollected = 0;
             }
 
-            result.MultiAppend(trajs);
+            // Merge in the stats each agent has published, and give their buffers back
+            // Agents only publish when we've taken their last stats, so samples reach us up to an iteration late, but none are lost
+            if (standardizeOBS) {
+                for (auto* agent : agents) {
+                    if (!agent->obsStatsPublished.load(std::memory_order_acquire))
+                        continue;
+
+                    obsStats.Merge(agent->publishedObsStats);
+                    lastCollectedObsStats.Merge(agent->publishedObsStats);
+                    agent->publishedObsStats.Reset();
+                    agent->obsStatsPublished.store(false, std::memory_order_release);
+                }
+            }
+
+            // There might be no local agents (see LearnerConfig::numCollectionWorkers)
+            if (!trajs.empty())
+                result.MultiAppend(trajs);
         }
         catch (const std::exception& e) {
             RG_ERR_CLOSE("Exception concatenating timesteps: " << e.what());
@@ -84,11 +123,35 @@ namespace RLGPC {
             RG_ERR_CLOSE("ThreadAgentManager::CollectTimesteps(): Timestep concatenation failed (" << result.size << " != " << totalTimesteps << ")");
         }
 
+        if (standardizeOBS)
+            UpdateOBSStandardization();
+
         lastIterationTime = iterationTimer.Elapsed();
         iterationTimer.Reset();
         return result;
     }
 
+    void ThreadAgentManager::AddOpponentVersion(DiscretePolicy* policy) {
+        auto version = std::make_shared<DiscretePolicy>(policy->inputAmount, policy->actionAmount, policy->layerSizes, policy->device);
+        policy->CopyTo(*version);
+
+        std::lock_guard<std::mutex> lock(opponentPoolMutex);
+        opponentPool.push_back(version);
+        if (opponentPool.size() > maxOpponentVersions)
+            opponentPool.erase(opponentPool.begin());
+    }
+
+    std::shared_ptr<DiscretePolicy> ThreadAgentManager::PickOpponent() {
+        if (opponentPoolFraction <= 0 || RocketSim::Math::RandFloat() >= opponentPoolFraction)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(opponentPoolMutex);
+        if (opponentPool.empty())
+            return nullptr;
+
+        return opponentPool[RocketSim::Math::RandInt(0, opponentPool.size())];
+    }
+
     void ThreadAgentManager::GetMetrics(Report& report) {
         AvgTracker avgStepRew, avgEpRew;
         for (auto* agent : agents) {
@@ -109,11 +172,49 @@ namespace RLGPC {
         }
 
         for (double& time : avgTimes) {
-            time /= agents.size();
+            time /= RS_MAX(agents.size(), (size_t)1);
         }
 
         report["Env Step Time"] = avgTimes.envStepTime;
         report["Policy Infer Time"] = avgTimes.policyInferTime + avgTimes.trajAppendTime;
+
+        if (opponentPoolFraction > 0) {
+            std::lock_guard<std::mutex> lock(opponentPoolMutex);
+            report["Opponent Pool Versions"] = opponentPool.size();
+        }
+
+        GetRewardTermMetrics(report);
+    }
+
+    void ThreadAgentManager::GetRewardTermMetrics(Report& report) {
+        // Merge the per-game profiles of all profiled CombinedRewards
+        std::vector<RLGSC::RewardTermProfile> merged;
+        RLGSC::CombinedReward* namesSource = NULL;
+        for (auto* agent : agents) {
+            std::lock_guard<std::mutex> lock(agent->gameStepMutex);
+            for (auto* game : agent->gameInsts) {
+                auto combinedReward = dynamic_cast<RLGSC::CombinedReward*>(game->match->rewardFn);
+                if (combinedReward && combinedReward->profile) {
+                    combinedReward->MergeProfiles(merged);
+                    if (!namesSource)
+                        namesSource = combinedReward;
+                }
+            }
+        }
+
+        if (!namesSource)
+            return;
+
+        for (int i = 0; i < merged.size(); i++) {
+            auto& termProfile = merged[i];
+            std::string prefix = "Reward Term " + namesSource->GetTermName(i);
+
+            // Averaged per agent, like "Env Step Time"
+            report[prefix + " Time"] = termProfile.time / agents.size();
+            report[prefix + " Mean"] = termProfile.mean;
+            report[prefix + " Abs Mean"] = termProfile.GetAbsMean();
+            report[prefix + " STD"] = termProfile.GetSTD();
+        }
     }
 
     void ThreadAgentManager::ResetMetrics() {
@@ -122,6 +223,10 @@ namespace RLGPC {
             std::lock_guard<std::mutex> lock(agent->gameStepMutex);
             for (auto* game : agent->gameInsts) {
                 game->ResetMetrics();
+
+                auto combinedReward = dynamic_cast<RLGSC::CombinedReward*>(game->match->rewardFn);
+                if (combinedReward && combinedReward->profile)
+                    combinedReward->ResetProfiles();
             }
         }
     }
@@ -130,6 +235,7 @@ namespace RLGPC {
         for (auto* agent : agents) {
             delete agent;
         }
+        delete obsStandardizer;
     }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "ThreadAgent.h"
 #include "../PPO/ExperienceBuffer.h"
+#include "../Util/OBSStandardizer.h"
 #include <RLGymPPO_CPP/Util/Report.h>
 #include <RLGymPPO_CPP/Util/WelfordRunningStat.h>
 #include <RLGymPPO_CPP/Util/Timer.h>
@@ -29,17 +30,40 @@ namespace RLGPC {
         Timer iterationTimer;
         double lastIterationTime = 0.0;
         WelfordRunningStat obsStats;
+        // The part of obsStats that was merged in by the last CollectTimesteps()
+        WelfordRunningStat lastCollectedObsStats;
+        OBSStandardizer* obsStandardizer = nullptr;
+        int stepsPerObsStatsInc = 5;
+
+        // Past policy versions that can control the opponent team of a game, see LearnerConfig::opponentPoolFraction
+        // Games hold on to their opponent, so removed versions are only freed once no game uses them
+        float opponentPoolFraction = 0;
+        int maxOpponentVersions = 8;
+        std::vector<std::shared_ptr<DiscretePolicy>> opponentPool;
+        std::mutex opponentPoolMutex;
 
         ThreadAgentManager(
             DiscretePolicy* policy, DiscretePolicy* policyHalf, ExperienceBuffer* expBuffer,
             bool standardizeOBS, bool deterministic, bool blockConcurrentInfer, uint64_t maxCollect, torch::Device device);
 
+        // Must be called before CreateAgents() if standardizeOBS is set
+        void InitOBSStandardization(int obsSize, float clipRange, int stepsPerStatsInc);
+        void UpdateOBSStandardization();
+
         void CreateAgents(EnvCreateFn func, int amount, int gamesPerAgent);
         void StartAgents();
         void StopAgents();
         void SetStepCallback(StepCallback callback);
+        // Adds a copy of the policy to the opponent pool
+        void AddOpponentVersion(DiscretePolicy* policy);
+        // Returns NULL if the game should be mirror self-play
+        std::shared_ptr<DiscretePolicy> PickOpponent();
         void GetMetrics(Report& report);
+        // Adds the merged stats of every profiled CombinedReward (see CombinedReward::EnableProfiling())
+        void GetRewardTermMetrics(Report& report);
         void ResetMetrics();
+        // Steps the agents have collected since the last CollectTimesteps()
+        uint64_t GetStepsCollected();
         GameTrajectory CollectTimesteps(uint64_t amount);
         ~ThreadAgentManager();
 
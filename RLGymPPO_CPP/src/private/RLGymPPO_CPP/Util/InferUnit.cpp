@@ -0,0 +1,269 @@
+#include "../../../public/RLGymPPO_CPP/Util/InferUnit.h"
+
+#include "../PPO/DiscretePolicy.h"
+#include "../PPO/ValueEstimator.h"
+#include "../FrameworkTorch.h"
+#include "OBSStandardizer.h"
+#include "RunningStatJSON.h"
+#include <torch/csrc/api/include/torch/serialize.h>
+
+using namespace RLGSC;
+using namespace RLGPC;
+
+RLGPC::InferUnit::InferUnit(
+    OBSBuilder* obsBuilder, ActionParser* actionParser,
+    std::filesystem::path modelPath, bool isPolicy, int obsSize, const IList& layerSizes, bool gpu)
+    : obsBuilder(obsBuilder), actionParser(actionParser), policy(nullptr), critic(nullptr), obsStandardizer(nullptr), obsStandardizerReader(nullptr) {
+
+    RG_LOG("InferUnit():");
+
+    RG_LOG(" > Creating policy/critic...");
+    torch::Device device = gpu ? torch::kCUDA : torch::kCPU;
+
+    try {
+        if (isPolicy) {
+            policy = new DiscretePolicy(obsSize, actionParser->GetActionAmount(), layerSizes, device);
+        }
+        else {
+            critic = new ValueEstimator(obsSize, layerSizes, device);
+        }
+
+        RG_LOG(" > > Loading policy/critic...");
+        std::ifstream streamIn(modelPath, std::ios::binary);
+        if (!streamIn.is_open()) {
+            RG_ERR_CLOSE("Can't open model file : " << modelPath);
+        }
+
+        if (policy) {
+            torch::load(policy->seq, streamIn, device);
+        }
+        else {
+            torch::load(critic->seq, streamIn, device);
+        }
+
+    }
+    catch (const std::exception& e) {
+        RG_ERR_CLOSE(
+            "Failed to load model, checkpoint may be corrupt or of different model arch.\n"
+            << "Exception : " << e.what()
+        );
+    }
+
+    RG_LOG(" > Termin !");
+}
+
+RLGPC::InferUnit::~InferUnit() {
+    delete policy;
+    delete critic;
+    delete obsStandardizer;
+    delete obsStandardizerReader;
+}
+
+void RLGPC::InferUnit::LoadOBSStats(std::filesystem::path runningStatsPath, float clipRange) {
+    constexpr const char* ERROR_PREFIX = "InferUnit::LoadOBSStats(): ";
+
+    std::ifstream fIn(runningStatsPath);
+    if (!fIn.good())
+        RG_ERR_CLOSE(ERROR_PREFIX << "Can't open file at " << runningStatsPath);
+
+    nlohmann::json j = nlohmann::json::parse(fIn);
+    if (!j.contains("obs_running_stats"))
+        RG_ERR_CLOSE(ERROR_PREFIX << "No observation stats in " << runningStatsPath << ", was the model trained with standardizeOBS?");
+
+    WelfordRunningStat obsStats = RunningStatFromJSON(j["obs_running_stats"]);
+
+    delete obsStandardizer;
+    obsStandardizer = new OBSStandardizer(obsStats.shape, clipRange);
+    obsStandardizer->SetStats(obsStats);
+
+    // Fetch the stats and move them to the model's device now, so inference only ever reads the reader
+    // This keeps _StandardizeOBS() safe to call from multiple threads at once
+    delete obsStandardizerReader;
+    obsStandardizerReader = new OBSStandardizerReader();
+    torch::Device device = policy ? policy->device : critic->device;
+    torch::Tensor warmupOBS = torch::zeros({ 1, obsStats.shape }, device);
+    obsStandardizer->Apply(warmupOBS, *obsStandardizerReader);
+}
+
+// Standardizes the observations in-place, if we have observation stats
+void _StandardizeOBS(OBSStandardizer* obsStandardizer, OBSStandardizerReader* reader, torch::Tensor& obs) {
+    if (!obsStandardizer)
+        return;
+
+    obsStandardizer->Apply(obs, *reader);
+}
+
+RLGSC::FList RLGPC::InferUnit::GetObs(const RLGSC::PlayerData& player, const RLGSC::GameState& state, const RLGSC::Action& prevAction) {
+    return obsBuilder->BuildOBS(player, state, prevAction);
+}
+
+RLGSC::FList2 RLGPC::InferUnit::GetObs(const RLGSC::GameState& state, const RLGSC::ActionSet& prevActions) {
+    FList2 obsSet;
+    if (state.players.size() != prevActions.size()) {
+        RG_ERR_CLOSE("InferUnit::GetObs: The size of state.players and prevActions does not match.");
+    }
+    for (size_t i = 0; i < state.players.size(); i++) {
+        obsSet.push_back(obsBuilder->BuildOBS(state.players[i], state, prevActions[i]));
+    }
+    return obsSet;
+}
+
+#define ASSERT_RIGHT_TYPE(name, otherName) \
+if ((name) == nullptr) RG_ERR_CLOSE("InferUnit: Failed to infer " #name " because this inference unit was created to infer " #otherName ".");
+
+ActionSet RLGPC::InferUnit::InferPolicyAll(
+    const GameState& state, const ActionSet& prevActions,
+    bool deterministic, float temperature
+) {
+
+    ASSERT_RIGHT_TYPE(policy, critic);
+
+    RG_NOGRAD;
+    policy->temperature = temperature;
+
+    torch::Tensor inputTen;
+    int obsSize = obsBuilder->GetOBSSize(state);
+    if (obsSize > 0) {
+        if (state.players.size() != prevActions.size())
+            RG_ERR_CLOSE("InferUnit::InferPolicyAll: The size of state.players and prevActions does not match.");
+
+        // Build straight into the input tensor
+        inputTen = torch::empty({ (int64_t)state.players.size(), obsSize });
+        obsBuilder->BuildAll(state, prevActions, inputTen.data_ptr<float>(), obsSize);
+        inputTen = inputTen.to(policy->device);
+    } else {
+        FList2 obsSet = GetObs(state, prevActions);
+        inputTen = FLIST2_TO_TENSOR(obsSet).to(policy->device);
+    }
+    _StandardizeOBS(obsStandardizer, obsStandardizerReader, inputTen);
+    auto actionResult = policy->GetAction(inputTen, deterministic);
+    auto actionParserInput = TENSOR_TO_ILIST(actionResult.action);
+
+    return actionParser->ParseActions(actionParserInput, state);
+}
+
+Action RLGPC::InferUnit::InferPolicySingle(
+    const PlayerData& player, const GameState& state, const Action& prevAction,
+    bool deterministic, float temperature
+) {
+    ASSERT_RIGHT_TYPE(policy, critic);
+
+    RG_NOGRAD;
+    policy->temperature = temperature;
+
+    torch::Tensor inputTen;
+    int obsSize = obsBuilder->GetOBSSize(state);
+    if (obsSize > 0) {
+        // Build into our own buffer, so nothing is allocated for the observation once it has grown to size
+        _singleOBS.resize(obsSize);
+        obsBuilder->BuildOBSInto(player, state, prevAction, _singleOBS.data());
+        inputTen = torch::from_blob(_singleOBS.data(), { obsSize });
+    } else {
+        inputTen = torch::tensor(GetObs(player, state, prevAction));
+    }
+
+    size_t playerIndex = 0;
+    for (size_t i = 0; i < state.players.size(); i++) {
+        if (state.players[i].carId == player.carId) {
+            playerIndex = i;
+            break;
+        }
+    }
+
+    inputTen = inputTen.to(policy->device);
+    _StandardizeOBS(obsStandardizer, obsStandardizerReader, inputTen);
+    auto actionResult = policy->GetAction(inputTen, deterministic);
+
+    return actionParser->ParseAction(actionResult.action.item<int>(), playerIndex, state);
+}
+
+std::vector<Action> RLGPC::InferUnit::InferPolicyBatch(
+    const std::vector<PlayerRequest>& requests,
+    bool deterministic, float temperature
+) {
+    ASSERT_RIGHT_TYPE(policy, critic);
+
+    if (requests.empty())
+        return {};
+
+    RG_NOGRAD;
+    policy->temperature = temperature;
+
+    // Build every request's observation into one input tensor
+    int64_t numRequests = requests.size();
+    torch::Tensor inputTen;
+    int obsSize = obsBuilder->GetOBSSize(*requests[0].state);
+    if (obsSize > 0) {
+        inputTen = torch::empty({ numRequests, obsSize });
+        float* out = inputTen.data_ptr<float>();
+        for (auto& request : requests) {
+            if (obsBuilder->GetOBSSize(*request.state) != obsSize)
+                RG_ERR_CLOSE("InferUnit::InferPolicyBatch: Observation sizes of the requests do not match.");
+            obsBuilder->BuildOBSInto(*request.player, *request.state, *request.prevAction, out);
+            out += obsSize;
+        }
+    } else {
+        FList2 obsSet;
+        for (auto& request : requests)
+            obsSet.push_back(GetObs(*request.player, *request.state, *request.prevAction));
+        inputTen = FLIST2_TO_TENSOR(obsSet);
+    }
+
+    inputTen = inputTen.to(policy->device);
+    _StandardizeOBS(obsStandardizer, obsStandardizerReader, inputTen);
+    IList actionIndices = TENSOR_TO_ILIST(policy->GetAction(inputTen, deterministic).action);
+
+    std::vector<Action> results(numRequests);
+    for (int64_t i = 0; i < numRequests; i++) {
+        auto& state = *requests[i].state;
+
+        size_t playerIndex = 0;
+        for (size_t j = 0; j < state.players.size(); j++) {
+            if (state.players[j].carId == requests[i].player->carId) {
+                playerIndex = j;
+                break;
+            }
+        }
+
+        results[i] = actionParser->ParseAction(actionIndices[i], playerIndex, state);
+    }
+
+    return results;
+}
+
+RLGSC::FList RLGPC::InferUnit::InferPolicySingleDistrib(
+    const PlayerData& player, const GameState& state, const Action& prevAction,
+    float temperature
+) {
+    ASSERT_RIGHT_TYPE(policy, critic);
+
+    FList obs = GetObs(player, state, prevAction);
+
+    RG_NOGRAD;
+    policy->temperature = temperature;
+    torch::Tensor inputTen = torch::tensor(obs).to(policy->device);
+    _StandardizeOBS(obsStandardizer, obsStandardizerReader, inputTen);
+    return TENSOR_TO_FLIST(policy->GetActionProbs(inputTen).reshape({ policy->actionAmount }));
+}
+
+RLGSC::FList RLGPC::InferUnit::InferCriticAll(const RLGSC::GameState& state, const RLGSC::ActionSet& prevActions) {
+    ASSERT_RIGHT_TYPE(critic, policy);
+
+    FList2 obsSet = GetObs(state, prevActions);
+
+    RG_NOGRAD;
+    torch::Tensor inputTen = FLIST2_TO_TENSOR(obsSet).to(critic->device);
+    _StandardizeOBS(obsStandardizer, obsStandardizerReader, inputTen);
+    return TENSOR_TO_FLIST(critic->Forward(inputTen).cpu());
+}
+
+float RLGPC::InferUnit::InferCriticSingle(const RLGSC::PlayerData& player, const RLGSC::GameState& state, const RLGSC::Action& prevAction) {
+    ASSERT_RIGHT_TYPE(critic, policy);
+
+    FList obs = GetObs(player, state, prevAction);
+
+    RG_NOGRAD;
+    torch::Tensor inputTen = torch::tensor(obs).to(critic->device);
+    _StandardizeOBS(obsStandardizer, obsStandardizerReader, inputTen);
+    return critic->Forward(inputTen).cpu().item<float>();
+}
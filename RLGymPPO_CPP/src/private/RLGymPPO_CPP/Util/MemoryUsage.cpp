@@ -0,0 +1,73 @@
+#include "MemoryUsage.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <limits>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#endif
+
+uint64_t RLGPC::GetProcessMemoryUsage() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return 0;
+#elif defined(__linux__)
+	// Second value of statm is the resident page count
+	std::ifstream statmIn("/proc/self/statm");
+	uint64_t totalPages = 0, residentPages = 0;
+	if (!(statmIn >> totalPages >> residentPages))
+		return 0;
+	return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+	return 0;
+#endif
+}
+
+uint64_t RLGPC::GetPeakMemoryUsage() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#elif defined(__linux__)
+	// "VmHWM:   1234 kB"
+	std::ifstream statusIn("/proc/self/status");
+	std::string key;
+	while (statusIn >> key) {
+		if (key == "VmHWM:") {
+			uint64_t kb = 0;
+			statusIn >> kb;
+			return kb * 1024;
+		}
+		statusIn.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+	}
+	return 0;
+#else
+	return 0;
+#endif
+}
+
+bool RLGPC::ResetPeakMemoryUsage() {
+#if defined(__linux__)
+#ifdef __GLIBC__
+	malloc_trim(0);
+#endif
+	// Writing 5 resets VmHWM to the current RSS (Linux 4.0+)
+	std::ofstream clearRefsOut("/proc/self/clear_refs");
+	clearRefsOut << "5";
+	clearRefsOut.flush();
+	return clearRefsOut.good();
+#else
+	// Windows can't reset PeakWorkingSetSize
+	return false;
+#endif
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <RLGymPPO_CPP/Framework.h>
+
+namespace RLGPC {
+	// Returns the resident memory (RSS) of this process in bytes, or 0 if it can't be determined on this platform
+	uint64_t GetProcessMemoryUsage();
+
+	// Returns the peak resident memory of this process in bytes since the last ResetPeakMemoryUsage() (or since it started),
+	//	or 0 if it can't be determined on this platform
+	uint64_t GetPeakMemoryUsage();
+
+	// Gives freed heap memory back to the OS where possible, then restarts the peak from the current memory usage
+	// Returns false if the peak can't be reset on this platform
+	bool ResetPeakMemoryUsage();
+}
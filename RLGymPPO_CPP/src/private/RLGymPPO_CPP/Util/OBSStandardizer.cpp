@@ -0,0 +1,35 @@
+#include "OBSStandardizer.h"
+
+RLGPC::OBSStandardizer::OBSStandardizer(int obsSize, float clipRange) : clipRange(clipRange) {
+	SetStats(WelfordRunningStat(obsSize));
+}
+
+void RLGPC::OBSStandardizer::SetStats(const WelfordRunningStat& stats) {
+	// Make new tensors instead of writing to the old ones, readers may still be using them
+	torch::Tensor newMean = torch::tensor(stats.Mean());
+	torch::Tensor newStd = torch::tensor(stats.GetSTD());
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	mean = newMean;
+	std = newStd;
+	version++;
+}
+
+void RLGPC::OBSStandardizer::Apply(torch::Tensor& obs, Reader& reader) {
+	if (reader.version != version) {
+		std::lock_guard<std::mutex> lock(statsMutex);
+		reader.mean = mean;
+		reader.std = std;
+		reader.version = version;
+	}
+
+	auto device = obs.device();
+	if (reader.mean.device() != device) {
+		reader.mean = reader.mean.to(device);
+		reader.std = reader.std.to(device);
+	}
+
+	obs.sub_(reader.mean).div_(reader.std);
+	if (clipRange > 0)
+		obs.clamp_(-clipRange, clipRange);
+}
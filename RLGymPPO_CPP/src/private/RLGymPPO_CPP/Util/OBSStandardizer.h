@@ -0,0 +1,37 @@
+#pragma once
+#include "../FrameworkTorch.h"
+#include <RLGymPPO_CPP/Util/WelfordRunningStat.h>
+#include <atomic>
+#include <mutex>
+
+namespace RLGPC {
+	// Each thread applying an OBSStandardizer keeps one of these
+	// Outside of OBSStandardizer so it can be forward-declared (see InferUnit)
+	struct OBSStandardizerReader {
+		uint64_t version = 0;
+		torch::Tensor mean, std;
+	};
+
+	// Standardizes batches of observations in-place using running observation statistics
+	// New statistics are published with a version counter, 
+	//	so threads applying the standardization only need to lock when the statistics actually change
+	struct OBSStandardizer {
+		float clipRange;
+
+		std::atomic<uint64_t> version = 0;
+		std::mutex statsMutex;
+		torch::Tensor mean, std;
+
+		typedef OBSStandardizerReader Reader;
+
+		// Clip range of 0 disables clipping
+		OBSStandardizer(int obsSize, float clipRange);
+
+		RG_NO_COPY(OBSStandardizer);
+
+		void SetStats(const WelfordRunningStat& stats);
+
+		// Subtracts the mean, divides by the standard deviation, and clips (all in-place)
+		void Apply(torch::Tensor& obs, Reader& reader);
+	};
+}
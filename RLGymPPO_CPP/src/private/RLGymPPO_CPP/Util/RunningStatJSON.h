@@ -0,0 +1,35 @@
+#pragma once
+#include <RLGymPPO_CPP/Util/WelfordRunningStat.h>
+#include "../../libsrc/json/nlohmann/json.hpp"
+#include <cmath>
+
+namespace RLGPC {
+	template <typename T>
+	nlohmann::json MakeJSONArray(const std::vector<T>& list) {
+		nlohmann::json result = nlohmann::json::array();
+		for (const T& v : list) {
+			if (std::isnan(v)) {
+				continue;
+			}
+			result.push_back(v);
+		}
+		return result;
+	}
+
+	inline nlohmann::json RunningStatToJSON(const WelfordRunningStat& stat) {
+		nlohmann::json result = {};
+		result["mean"] = MakeJSONArray(stat.runningMean);
+		result["var"] = MakeJSONArray(stat.runningVariance);
+		result["shape"] = stat.shape;
+		result["count"] = stat.count;
+		return result;
+	}
+
+	inline WelfordRunningStat RunningStatFromJSON(const nlohmann::json& j) {
+		WelfordRunningStat result = WelfordRunningStat(j["shape"]);
+		result.runningMean = j["mean"].get<std::vector<double>>();
+		result.runningVariance = j["var"].get<std::vector<double>>();
+		result.count = j["count"];
+		return result;
+	}
+}
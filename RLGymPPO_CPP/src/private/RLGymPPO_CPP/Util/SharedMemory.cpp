@@ -0,0 +1,134 @@
+#include "SharedMemory.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace RLGPC;
+
+std::string _GetSystemName(const std::string& name) {
+#if defined(_WIN32)
+	return "Local\\" + name;
+#else
+	return "/" + name;
+#endif
+}
+
+SharedMemory* SharedMemory::Create(const std::string& name, size_t size) {
+	constexpr const char* ERR_PREFIX = "SharedMemory::Create(): ";
+
+	SharedMemory* result = new SharedMemory();
+	result->name = name;
+	result->size = size;
+	result->_isOwner = true;
+	std::string systemName = _GetSystemName(name);
+
+#if defined(_WIN32)
+	HANDLE mapHandle = CreateFileMappingA(
+		INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), systemName.c_str()
+	);
+	if (!mapHandle)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to create \"" << name << "\" (error " << GetLastError() << ")");
+	if (GetLastError() == ERROR_ALREADY_EXISTS)
+		RG_ERR_CLOSE(ERR_PREFIX << "\"" << name << "\" is already in use by another process");
+
+	result->_mapHandle = mapHandle;
+	result->data = (byte*)MapViewOfFile(mapHandle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#else
+	// A previous owner might have crashed without removing it
+	shm_unlink(systemName.c_str());
+
+	int fileDesc = shm_open(systemName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fileDesc < 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to create \"" << name << "\" (errno " << errno << ")");
+
+	if (ftruncate(fileDesc, size) != 0) {
+		close(fileDesc);
+		shm_unlink(systemName.c_str());
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to resize \"" << name << "\" to " << size << " bytes (errno " << errno << ")");
+	}
+
+	void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDesc, 0);
+	close(fileDesc);
+	if (mapping != MAP_FAILED)
+		result->data = (byte*)mapping;
+#endif
+
+	if (!result->data)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to map \"" << name << "\"");
+
+	// New mappings are already zero-filled
+	return result;
+}
+
+SharedMemory* SharedMemory::Open(const std::string& name) {
+	constexpr const char* ERR_PREFIX = "SharedMemory::Open(): ";
+
+	std::string systemName = _GetSystemName(name);
+	SharedMemory* result = new SharedMemory();
+	result->name = name;
+
+#if defined(_WIN32)
+	HANDLE mapHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName.c_str());
+	if (!mapHandle) {
+		delete result;
+		return NULL;
+	}
+
+	result->_mapHandle = mapHandle;
+	result->data = (byte*)MapViewOfFile(mapHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (result->data) {
+		// Rounded up to the page size, but everything stored in shared memory carries its own size anyway
+		MEMORY_BASIC_INFORMATION memInfo = {};
+		VirtualQuery(result->data, &memInfo, sizeof(memInfo));
+		result->size = memInfo.RegionSize;
+	}
+#else
+	int fileDesc = shm_open(systemName.c_str(), O_RDWR, 0600);
+	if (fileDesc < 0) {
+		delete result;
+		return NULL;
+	}
+
+	struct stat fileStat = {};
+	fstat(fileDesc, &fileStat);
+	result->size = fileStat.st_size;
+
+	// The creator might not have resized it yet
+	if (result->size == 0) {
+		close(fileDesc);
+		delete result;
+		return NULL;
+	}
+
+	void* mapping = mmap(NULL, result->size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDesc, 0);
+	close(fileDesc);
+	if (mapping != MAP_FAILED)
+		result->data = (byte*)mapping;
+#endif
+
+	if (!result->data)
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to map \"" << name << "\"");
+
+	return result;
+}
+
+SharedMemory::~SharedMemory() {
+#if defined(_WIN32)
+	if (data)
+		UnmapViewOfFile(data);
+	if (_mapHandle)
+		CloseHandle(_mapHandle);
+#else
+	if (data)
+		munmap(data, size);
+	if (_isOwner)
+		shm_unlink(_GetSystemName(name).c_str());
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <RLGymPPO_CPP/Framework.h>
+
+namespace RLGPC {
+	// A named block of memory shared between processes on the same machine
+	// Uses POSIX shared memory (shm_open()), or a named file mapping on Windows
+	class SharedMemory {
+	public:
+		std::string name;
+		byte* data = NULL;
+		size_t size = 0;
+
+		// Creates the block (replacing any existing block with that name), zero-filled
+		// The creator owns the name, and removes it once destroyed
+		static SharedMemory* Create(const std::string& name, size_t size);
+
+		// Maps an existing block, returns NULL if there is no block with that name
+		static SharedMemory* Open(const std::string& name);
+
+		RG_NO_COPY(SharedMemory);
+
+		~SharedMemory();
+
+	private:
+		bool _isOwner = false;
+		void* _mapHandle = NULL;
+
+		SharedMemory() = default;
+	};
+}
@@ -35,6 +35,8 @@ RLGPC::SkillTracker::SkillTracker(const SkillTrackerConfig& config, RenderSender
 
 	curRating = {};
 
+	threadPool = new ThreadPool(config.numThreads);
+
 	if (!config.perModeRatings)
 		curRating.data[""] = config.initialRating;
 
@@ -57,11 +59,25 @@ RLGPC::SkillTracker::SkillTracker(const SkillTrackerConfig& config, RenderSender
 			curRating.data[modeName] = config.initialRating;
 		}
 
-		games.push_back(Game(gameInst, 1));
+		games.push_back(Game(gameInst));
 	}
+
+	// Checked here, as evals can run on the background service, which must not close the learner
+	float timePerGame = config.simTime / games.size();
+	for (auto& game : games)
+		if (timePerGame * 120 / game.gameInst->gym->tickSkip < 1)
+			RG_ERR_CLOSE("SkillTracker: simTime is too low for the number of games, there is not enough time per game to step");
 }
 
 RLGPC::SkillTracker::~SkillTracker() {
+	Stop();
+	delete threadPool;
+	delete evalPolicy;
+	delete _publishedPolicy;
+
+	for (auto& policy : _pendingVersions)
+		delete policy;
+
 	for (auto& policy : oldPolicies)
 		delete policy;
 
@@ -84,175 +100,373 @@ void RLGPC::SkillTracker::UpdateRatings(RatingSet& winner, RatingSet& loser, boo
 		loser.data[mode] += config.ratingInc * (expected - 1);
 }
 
-void RunThread(
-	RLGPC::SkillTracker* self, std::vector<RLGPC::SkillTracker::Game*> games, DiscretePolicy* curPolicy, float timePerGame, 
-	int threadIdx, std::mutex* ratingMutex, char* done) {
-	constexpr const char* ERR_PREFIX = "RLGPC::SkillTracker RunThread(): ";
-	
-	for (auto gamePtr : games) {
-		auto& game = *gamePtr;
-		auto& gameInst = game.gameInst;
-		gameInst->stepCallback = self->config.stepCallback;
-
-		DiscretePolicy* oldPolicy = self->oldPolicies[game.oldPolicyIndex];
-		int tickSkip = gameInst->gym->tickSkip;
-		int numSteps = timePerGame * 120 / tickSkip;
-		if (numSteps <= 0)
-			RG_ERR_CLOSE(ERR_PREFIX << "simTime is too low for the number of games, there is not enough time per game to step");
-
-		for (int i = 0; i < numSteps; i++) {
-			RG_NOGRAD;
-
-			FList2 curObsSet = gameInst->curObs;
-
-			FList2 teamObsSets[2] = {};
-			for (int j = 0; j < gameInst->match->playerAmount; j++)
-				teamObsSets[(int)gameInst->gym->prevState.players[j].team].push_back(curObsSet[j]);
-
-			auto bluePolicy = game.teamSwap ? oldPolicy : curPolicy;
-			auto orangePolicy = game.teamSwap ? curPolicy : oldPolicy;
-
-			auto blueObs = FLIST2_TO_TENSOR(teamObsSets[0]).to(bluePolicy->device);
-			auto orangeObs = FLIST2_TO_TENSOR(teamObsSets[1]).to(orangePolicy->device);
-
-			auto blueActions = TENSOR_TO_ILIST(bluePolicy->GetAction(blueObs, 1).action);
-			auto orangeActions = TENSOR_TO_ILIST(orangePolicy->GetAction(orangeObs, 1).action);
-
-			IList allActions = {};
-			for (int j = 0, blueIdx = 0, orangeIdx = 0; j < gameInst->match->playerAmount; j++) {
-				Team playerTeam = gameInst->gym->prevState.players[j].team;
-				if (playerTeam == Team::BLUE) {
-					allActions.push_back(blueActions[blueIdx]);
-					blueIdx++;
-				} else {
-					allActions.push_back(orangeActions[orangeIdx]);
-					orangeIdx++;
+DiscretePolicy* CopyPolicy(DiscretePolicy* policy) {
+	DiscretePolicy* copy = new DiscretePolicy(policy->inputAmount, policy->actionAmount, policy->layerSizes, policy->device);
+	policy->CopyTo(*copy);
+	return copy;
+}
+
+void RLGPC::SkillTracker::_StepGames(int step, const std::vector<int>& gameNumSteps) {
+	int numThreads = threadPool->threads.size();
+	for (int i = 0; i < numThreads; i++) {
+		threadPool->StartJob(
+			[this, i, numThreads, step, &gameNumSteps]() {
+				for (int gameIdx = i; gameIdx < games.size(); gameIdx += numThreads)
+					if (step < gameNumSteps[gameIdx])
+						_stepResults[gameIdx] = games[gameIdx].gameInst->Step(_gameActions[gameIdx]);
+			}
+		);
+	}
+
+	threadPool->WaitForJobs();
+}
+
+void RLGPC::SkillTracker::_RunEval() {
+	constexpr const char* ERR_PREFIX = "RLGPC::SkillTracker::_RunEval(): ";
+
+	RG_NOGRAD;
+
+	RatingSet prevRating = curRating;
+
+	float timePerGame = config.simTime / games.size();
+
+	std::vector<int> gameNumSteps = std::vector<int>(games.size());
+	int maxSteps = 0;
+	for (int i = 0; i < games.size(); i++) {
+		auto gameInst = games[i].gameInst;
+		gameInst->stepCallback = config.stepCallback;
+
+		gameNumSteps[i] = timePerGame * 120 / gameInst->gym->tickSkip; // At least 1, see the constructor
+		maxSteps = RS_MAX(maxSteps, gameNumSteps[i]);
+	}
+
+	// Old versions come first, the current policy is the last version
+	int curVersion = oldPolicies.size();
+	int numVersions = curVersion + 1;
+	_versionOBS.resize(numVersions);
+	_versionActions.resize(numVersions);
+	_gameActions.resize(games.size());
+	_stepResults.resize(games.size());
+
+	auto fnGetPlayerVersion = [curVersion](const Game& game, Team team) {
+		// Without a team swap, blue is the current policy
+		return ((team == Team::BLUE) != game.teamSwap) ? curVersion : game.oldPolicyIndex;
+	};
+
+	for (auto& game : games) {
+		if (game.oldPolicyIndex == -1 && !_ScheduleMatchup(game)) {
+			RG_LOG(ERR_PREFIX << "No old versions to play against, skipping this eval round");
+			return;
+		}
+	}
+
+	OBSStandardizer::Reader obsStandardizerReader = {};
+
+	for (int step = 0; step < maxSteps && !_stopService; step++) {
+
+		// Group the observations of all games by the policy version controlling them
+		std::vector<int> versionOBSSizes = std::vector<int>(numVersions, -1);
+		for (auto& obs : _versionOBS)
+			obs.clear();
+
+		for (int gameIdx = 0; gameIdx < games.size(); gameIdx++) {
+			if (step >= gameNumSteps[gameIdx])
+				continue;
+
+			auto& game = games[gameIdx];
+			auto gameInst = game.gameInst;
+			for (int j = 0; j < gameInst->match->playerAmount; j++) {
+				int version = fnGetPlayerVersion(game, gameInst->gym->prevState.players[j].team);
+				auto& obs = gameInst->curObs[j];
+
+				if (versionOBSSizes[version] == -1) {
+					versionOBSSizes[version] = obs.size();
+				} else if (versionOBSSizes[version] != obs.size()) {
+					// Not fatal, since this can run on the background service
+					RG_LOG(ERR_PREFIX << "Observation size (" << obs.size() << ") does not match other observations for the same policy (" << versionOBSSizes[version] << "), ending this eval round");
+					return;
 				}
+
+				_versionOBS[version].insert(_versionOBS[version].end(), obs.begin(), obs.end());
+			}
+		}
+
+		// One forward pass per policy version
+		for (int version = 0; version < numVersions; version++) {
+			int obsSize = versionOBSSizes[version];
+			if (obsSize == -1)
+				continue;
+
+			DiscretePolicy* policy = (version == curVersion) ? evalPolicy : oldPolicies[version];
+
+			int64_t numRows = _versionOBS[version].size() / obsSize;
+			torch::Tensor obsTensor = torch::from_blob(_versionOBS[version].data(), { numRows, (int64_t)obsSize });
+
+			if (obsStandardizer)
+				obsStandardizer->Apply(obsTensor, obsStandardizerReader);
+
+			obsTensor = obsTensor.to(policy->device);
+			_versionActions[version] = TENSOR_TO_ILIST(policy->GetAction(obsTensor, true).action);
+		}
+
+		// Give the actions back to each game, in the same order they were grouped
+		std::vector<int> versionActionIndices = std::vector<int>(numVersions, 0);
+		for (int gameIdx = 0; gameIdx < games.size(); gameIdx++) {
+			if (step >= gameNumSteps[gameIdx])
+				continue;
+
+			auto& game = games[gameIdx];
+			auto gameInst = game.gameInst;
+			auto& actions = _gameActions[gameIdx];
+			actions.resize(gameInst->match->playerAmount);
+			for (int j = 0; j < gameInst->match->playerAmount; j++) {
+				int version = fnGetPlayerVersion(game, gameInst->gym->prevState.players[j].team);
+				actions[j] = _versionActions[version][versionActionIndices[version]++];
 			}
+		}
+
+		_StepGames(step, gameNumSteps);
+
+		// Ratings and resets are done here, so the step jobs don't need to share anything
+		for (int gameIdx = 0; gameIdx < games.size(); gameIdx++) {
+			if (step >= gameNumSteps[gameIdx])
+				continue;
+
+			auto& game = games[gameIdx];
+			auto& stepResult = _stepResults[gameIdx];
 
-			auto stepResult = gameInst->Step(allActions);
 			if (RLGSC::Math::IsBallScored(stepResult.state.ball.pos)) {
-				auto scoringPolicy = (stepResult.state.ball.pos.y > 0) ? bluePolicy : orangePolicy;
-				std::string modeName = ModeNameFromGameInst(game.gameInst);
-				if (!self->config.perModeRatings)
-					modeName = "";
+				bool blueScored = stepResult.state.ball.pos.y > 0;
+				bool curPolicyScored = blueScored != game.teamSwap;
+				std::string modeName = config.perModeRatings ? ModeNameFromGameInst(game.gameInst) : "";
 
-				ratingMutex->lock();
-				if (scoringPolicy == curPolicy) {
+				std::lock_guard<std::mutex> lock(ratingMutex);
+				if (curPolicyScored) {
 					// Current policy scored
-					self->UpdateRatings(self->curRating, self->oldRatings[game.oldPolicyIndex], true, true, modeName);
+					UpdateRatings(curRating, oldRatings[game.oldPolicyIndex], true, true, modeName);
 				} else {
 					// Old policy scored
-					self->UpdateRatings(self->oldRatings[game.oldPolicyIndex], self->curRating, true, true, modeName);
+					UpdateRatings(oldRatings[game.oldPolicyIndex], curRating, true, true, modeName);
 				}
-				ratingMutex->unlock();
 			}
 
-			if (stepResult.done)
-				game.Reset(self->oldPolicies.size());
-
-			if (self->renderSender && threadIdx == 0) {
-				self->renderSender->Send(stepResult.state, gameInst->match->prevActions);
-				float sleepTime = gameInst->gym->tickSkip / 120.f;
-				std::this_thread::sleep_for(std::chrono::microseconds(int64_t(sleepTime * 1000 * 1000)));
+			if (stepResult.done && !_ScheduleMatchup(game)) {
+				RG_LOG(ERR_PREFIX << "No old versions to play against, ending this eval round early");
+				return;
 			}
 		}
+
+		if (renderSender && step < gameNumSteps[0]) {
+			auto gameInst = games[0].gameInst;
+			renderSender->Send(_stepResults[0].state, gameInst->match->prevActions);
+			float sleepTime = gameInst->gym->tickSkip / 120.f;
+			std::this_thread::sleep_for(std::chrono::microseconds(int64_t(sleepTime * 1000 * 1000)));
+		}
 	}
 
-	*done = true;
+	evalRounds++;
+
+	// The background service's rounds show up in the metrics instead
+	if (config.runInBackground)
+		return;
+
+	RG_LOG("New ratings:");
+	for (auto& pair : curRating.data) {
+		if (prevRating.data.find(pair.first) == prevRating.data.end())
+			continue;
+
+		float prev = prevRating.data[pair.first];
+		float delta = pair.second - prev;
+		RG_LOG(
+			" > " << pair.first << (pair.first.empty() ? "" : " ") << std::setprecision(6) << pair.second << 
+			" (" << (delta >= 0 ? "+" : "") << std::setprecision(4) << delta << ")"
+		);
+	}
 }
 
-void RLGPC::SkillTracker::RunGames(DiscretePolicy* curPolicy, int64_t timestepsDelta) {
-	constexpr const char* ERR_PREFIX = "RLGPC::SkillTracker::RunGames(): ";
+void RLGPC::SkillTracker::_AddVersion(DiscretePolicy* policy) {
+	// Reset all games
+	for (auto& game : games) {
+		game.gameInst->Start();
+		game.oldPolicyIndex = -1;
+	}
 
-	if (runCounter % config.updateInterval != 0) {
-		runCounter++;
-		return;
-	} else {
-		runCounter++;
+	std::lock_guard<std::mutex> lock(ratingMutex);
+	oldPolicies.push_back(policy);
+	oldRatings.push_back(curRating);
+	_noVersionsAvailable = false;
+
+	if (oldPolicies.size() > config.maxVersions) {
+		delete oldPolicies[0];
+		oldPolicies.erase(oldPolicies.begin());
+		oldRatings.erase(oldRatings.begin());
+	}
+}
+
+bool RLGPC::SkillTracker::_ScheduleMatchup(Game& game) {
+	constexpr const char* ERR_PREFIX = "RLGPC::SkillTracker::_ScheduleMatchup(): ";
+
+	// Every version still gets played a bit, so ratings that are off can be corrected
+	constexpr float MIN_WEIGHT = 0.05f;
+
+	game.teamSwap = RocketSim::Math::RandFloat() > 0.5f;
+
+	std::string modeName = config.perModeRatings ? ModeNameFromGameInst(game.gameInst) : "";
+
+	// A goal tells us the most about the rating difference when both sides are equally likely to score it,
+	//	so versions are weighted by the variance of the expected outcome
+	std::vector<float> weights = std::vector<float>(oldPolicies.size());
+	float totalWeight = 0;
+	{
+		std::lock_guard<std::mutex> lock(ratingMutex);
+		for (int i = 0; i < oldPolicies.size(); i++) {
+			float expDelta = (oldRatings[i].data[modeName] - curRating.data[modeName]) / 400;
+			float expected = 1 / (powf(10, expDelta) + 1);
+			weights[i] = expected * (1 - expected) + MIN_WEIGHT;
+			totalWeight += weights[i];
+		}
 	}
 
-	if (oldPolicies.empty() && config.startWithVersion) {
-		DiscretePolicy* newOldPolicy = new DiscretePolicy(curPolicy->inputAmount, curPolicy->actionAmount, curPolicy->layerSizes, curPolicy->device);
-		curPolicy->CopyTo(*newOldPolicy);
-		oldPolicies.push_back(newOldPolicy);
-		oldRatings.push_back(curRating);
+	// This can run on the background service, so it must not close the learner
+	if (totalWeight <= 0) {
+		game.oldPolicyIndex = -1;
+		_noVersionsAvailable = true;
+		return false;
 	}
 
-	if (oldPolicies.size() > 0) {
-		RatingSet prevRating = curRating;
+	int index = 0;
+	float pick = RocketSim::Math::RandFloat() * totalWeight;
+	for (int i = 0; i < weights.size(); i++) {
+		index = i;
+		pick -= weights[i];
+		if (pick < 0)
+			break;
+	}
 
-		float timePerGame = config.simTime / games.size();
+	game.oldPolicyIndex = index;
+	return true;
+}
 
-		std::vector<std::thread*> threads = {};
-		std::vector<char> threadDones = {};
-		std::vector<std::vector<Game*>> threadGameSets = {};
-		threads.resize(config.numThreads);
-		threadDones.resize(config.numThreads);
-		threadGameSets.resize(config.numThreads);
-		for (int gameIdx = 0; gameIdx < games.size(); gameIdx++)
-			threadGameSets[gameIdx % config.numThreads].push_back(&games[gameIdx]);
+void RLGPC::SkillTracker::_ServiceLoop() {
+	while (true) {
+		std::vector<DiscretePolicy*> newVersions = {};
+		{
+			std::unique_lock<std::mutex> lock(_publishMutex);
+
+			// With continuous eval, the last snapshot keeps getting evaluated until a new one is published
+			// There has to be an old version to evaluate it against though, otherwise this would just spin
+			auto fnCanEvalAgain = [&]() {
+				return config.continuousEval && evalPolicy && !oldPolicies.empty() && !_noVersionsAvailable;
+			};
+			while (!_stopService && !_hasNewPublish && _pendingVersions.empty() && !fnCanEvalAgain())
+				_publishCondVar.wait(lock);
+
+			if (_stopService)
+				break;
+
+			if (_hasNewPublish) {
+				std::swap(evalPolicy, _publishedPolicy);
+				_hasNewPublish = false;
+			}
 
-		std::mutex ratingMutex = {};
+			newVersions.swap(_pendingVersions);
+		}
+
+		if (!oldPolicies.empty())
+			_RunEval();
 
-		for (int i = 0; i < config.numThreads; i++) {
-			if (!threadGameSets[i].empty()) {
-				std::thread* thread = new std::thread(RunThread, this, threadGameSets[i], curPolicy, timePerGame, i, &ratingMutex, &threadDones[i]);
-				thread->detach();
-				threads[i] = thread;
+		for (auto version : newVersions) {
+			if (_stopService) {
+				delete version;
 			} else {
-				threads[i] = NULL;
+				_AddVersion(version);
 			}
 		}
+	}
+}
 
-		for (int i = 0; i < threads.size(); i++) {
-			if (threads[i] == NULL)
-				continue;
+void RLGPC::SkillTracker::Stop() {
+	if (!serviceThread.joinable())
+		return;
 
-			while (!threadDones[i])
-				THREAD_WAIT();
+	{
+		std::lock_guard<std::mutex> lock(_publishMutex);
+		_stopService = true;
+		_publishCondVar.notify_all();
+	}
 
-			if (threads[i]->joinable())
-				threads[i]->join();
-			delete threads[i];
-		}
-		threads.clear();
+	serviceThread.join();
+}
 
-		RG_LOG("New ratings:");
-		for (auto& pair : curRating.data) {
-			if (prevRating.data.find(pair.first) == prevRating.data.end())
-				continue;
+void RLGPC::SkillTracker::GetMetrics(Report& report) {
+	for (auto& pair : GetCurRating().data) {
+		std::string metricName = "Skill Rating" + (pair.first.empty() ? "" : " " + pair.first);
+		report[metricName] = pair.second;
+	}
 
-			float prev = prevRating.data[pair.first];
-			float delta = pair.second - prev;
-			RG_LOG(
-				" > " << pair.first << (pair.first.empty() ? "" : " ") << std::setprecision(6) << pair.second << 
-				" (" << (delta >= 0 ? "+" : "") << std::setprecision(4) << delta << ")"
-			);
-		}
+	report["Skill Eval Rounds"] = evalRounds.load();
+}
+
+void RLGPC::SkillTracker::RunGames(DiscretePolicy* curPolicy, int64_t timestepsDelta) {
+	constexpr const char* ERR_PREFIX = "RLGPC::SkillTracker::RunGames(): ";
+
+	if (runCounter % config.updateInterval != 0) {
+		runCounter++;
+		return;
 	} else {
-		RG_LOG(" > No old policies yet, skipping");
+		runCounter++;
 	}
 
+	// Once the service is running, only it touches the old versions
+	if (oldPolicies.empty() && config.startWithVersion && !serviceThread.joinable())
+		AppendOldPolicy(CopyPolicy(curPolicy), curRating);
+
+	// Add current policy as previous version once the run is done
+	DiscretePolicy* newVersion = NULL;
 	timestepsSinceVersionMade += timestepsDelta;
 	if (timestepsSinceVersionMade >= config.timestepsPerVersion) {
-		// Reset all games
-		for (auto game : games)
-			game.gameInst->Start();
-
 		timestepsSinceVersionMade = 0;
+		newVersion = CopyPolicy(curPolicy);
+	}
 
-		// Add current policy as previous version
-		DiscretePolicy* newOldPolicy = new DiscretePolicy(curPolicy->inputAmount, curPolicy->actionAmount, curPolicy->layerSizes, curPolicy->device);
-		curPolicy->CopyTo(*newOldPolicy);
-		oldPolicies.push_back(newOldPolicy);
-		oldRatings.push_back(curRating);
+	if (config.runInBackground) {
+		// The service evaluates its own copy, so the learner can keep updating curPolicy
+		{
+			std::lock_guard<std::mutex> lock(_publishMutex);
+			if (_publishedPolicy) {
+				curPolicy->CopyTo(*_publishedPolicy);
+			} else {
+				_publishedPolicy = CopyPolicy(curPolicy);
+			}
+			_hasNewPublish = true;
 
-		if (oldPolicies.size() > config.maxVersions) {
-			delete oldPolicies[0];
-			oldPolicies.erase(oldPolicies.begin());
-			oldRatings.erase(oldRatings.begin());
+			if (newVersion)
+				_pendingVersions.push_back(newVersion);
+
+			_publishCondVar.notify_all();
 		}
+
+		if (!serviceThread.joinable()) {
+			// Might be left over from a previous Stop()
+			_stopService = false;
+			serviceThread = std::thread(&SkillTracker::_ServiceLoop, this);
+		}
+
+	} else {
+		if (!oldPolicies.empty()) {
+			if (evalPolicy) {
+				curPolicy->CopyTo(*evalPolicy);
+			} else {
+				evalPolicy = CopyPolicy(curPolicy);
+			}
+
+			_RunEval();
+		} else {
+			RG_LOG(" > No old policies yet, skipping");
+		}
+
+		if (newVersion)
+			_AddVersion(newVersion);
 	}
 }
 
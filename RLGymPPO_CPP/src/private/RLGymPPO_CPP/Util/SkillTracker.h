@@ -3,28 +3,28 @@
 #include "../../../public/RLGymPPO_CPP/Util/SkillTrackerConfig.h"
 #include "../../../public/RLGymPPO_CPP/Util/RenderSender.h"
 #include "../PPO/DiscretePolicy.h"
+#include "OBSStandardizer.h"
+#include "ThreadPool.h"
 
 #include "../../libsrc/json/nlohmann/json.hpp"
 
 #include <public/RLGymPPO_CPP/Threading/GameInst.h>
 
+#include <atomic>
+
 namespace RLGPC {
 	struct SkillTracker {
 		RenderSender* renderSender = NULL;
 
+		// Applied to eval observations if set (not owned)
+		OBSStandardizer* obsStandardizer = NULL;
+
 		struct Game {
 			GameInst* gameInst;
 			bool teamSwap = false; // To prevent potential bias towards 1 team, the team assignment for old vs current policy is randomized every env reset
-			int oldPolicyIndex = 0;
-
-			Game(GameInst* gameInst, int numPolicies) : gameInst(gameInst) {
-				Reset(numPolicies);
-			}
+			int oldPolicyIndex = -1; // -1 if there is no matchup yet
 
-			void Reset(int numPolicies) {
-				teamSwap = RocketSim::Math::RandFloat() > 0.5f;
-				oldPolicyIndex = RocketSim::Math::RandInt(0, numPolicies);
-			}
+			Game(GameInst* gameInst) : gameInst(gameInst) {}
 		};
 
 		std::vector<Game> games;
@@ -47,12 +47,56 @@ namespace RLGPC {
 
 		RatingSet curRating;
 
+		// Steps the eval games in parallel, persists between runs
+		ThreadPool* threadPool = NULL;
+
+		// Copy of the current policy that the eval games are run against
+		DiscretePolicy* evalPolicy = NULL;
+
+		// Guards curRating and oldRatings while the service is updating them
+		std::mutex ratingMutex = {};
+
+		std::atomic<uint64_t> evalRounds = 0;
+
+		// Background service, used when config.runInBackground is set
+		std::thread serviceThread;
+		std::atomic<bool> _stopService = false;
+		std::mutex _publishMutex = {};
+		std::condition_variable _publishCondVar = {};
+		// Latest published snapshot, swapped with evalPolicy at the start of a round
+		DiscretePolicy* _publishedPolicy = NULL;
+		bool _hasNewPublish = false;
+		// Versions to add after the current round
+		std::vector<DiscretePolicy*> _pendingVersions;
+		// Set when a round was skipped because no old version could be loaded, until another version is added
+		bool _noVersionsAvailable = false;
+
+		// Re-used every step of a run, per policy version (last version is the current policy)
+		std::vector<FList> _versionOBS;
+		std::vector<IList> _versionActions;
+		// Re-used every step of a run, per game
+		std::vector<IList> _gameActions;
+		std::vector<RLGSC::Gym::StepResult> _stepResults;
+
 		SkillTracker(const SkillTrackerConfig& config, RenderSender* renderSender = NULL);
 
 		RG_NO_COPY(SkillTracker);
 
+		// Evaluates curPolicy against the old versions (only every config.updateInterval calls)
+		// If config.runInBackground is set, this only publishes a snapshot of curPolicy to the service and returns right away
 		void RunGames(DiscretePolicy* curPolicy, int64_t timestepsDelta);
 
+		// Stops the background service after its current step, if it is running
+		void Stop();
+
+		RatingSet GetCurRating() {
+			std::lock_guard<std::mutex> lock(ratingMutex);
+			return curRating;
+		}
+
+		// Adds the latest ratings and eval stats to a report
+		void GetMetrics(Report& report);
+
 		void UpdateRatings(RatingSet& winner, RatingSet& loser, bool updateWinner, bool updateLoser, std::string mode);
 
 		void AppendOldPolicy(DiscretePolicy* policy, RatingSet rating) {
@@ -60,6 +104,14 @@ namespace RLGPC {
 			oldRatings.push_back(rating);
 		}
 
+		void _ServiceLoop();
+		void _RunEval();
+		void _StepGames(int step, const std::vector<int>& gameNumSteps);
+		void _AddVersion(DiscretePolicy* policy);
+		// Picks the old version and team assignment of a game
+		// Returns false if no old version is available to play against
+		bool _ScheduleMatchup(Game& game);
+
 		~SkillTracker();
 	};
 }
\ No newline at end of file
@@ -7,6 +7,7 @@ namespace RLGPC {
 
 		std::mutex lockMutex = {};
 		std::condition_variable condVar = {};
+		std::condition_variable jobsDoneCondVar = {};
 		bool shouldShutdown = false;
 		std::queue<std::function<void(void)>> _jobs = {};
 		std::vector<std::thread> threads = {};
@@ -48,6 +49,13 @@ namespace RLGPC {
 			return _activeJobCounter;
 		}
 
+		// Blocks until every started job has finished
+		void WaitForJobs() {
+			std::unique_lock<std::mutex> lock(lockMutex);
+			while (_activeJobCounter > 0)
+				jobsDoneCondVar.wait(lock);
+		}
+
 		void _ThreadEntry(int i) {
 			std::function<void(void)> jobFunc;
 
@@ -73,6 +81,8 @@ namespace RLGPC {
 				{
 					std::unique_lock<std::mutex> lock(lockMutex);
 					_activeJobCounter--;
+					if (_activeJobCounter == 0)
+						jobsDoneCondVar.notify_all();
 				}
 			}
 		}
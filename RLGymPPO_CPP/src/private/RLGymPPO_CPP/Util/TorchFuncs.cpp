@@ -3,52 +3,58 @@
 #include <torch/csrc/api/include/torch/serialize.h>
 
 void RLGPC::TorchFuncs::ComputeGAE(
-	const FList& rews, const FList& dones, const FList& truncated, const FList& values, 
-	torch::Tensor& outAdvantages, torch::Tensor& outValues, FList& outReturns, 
+	torch::Tensor rews, torch::Tensor dones, torch::Tensor truncated, torch::Tensor values, torch::Tensor nextValues,
+	torch::Tensor& outAdvantages, torch::Tensor& outValues, torch::Tensor& outReturns,
 	float gamma, float lambda, float returnStd, float clipRange
 ) {
-	auto next_values = FList(values.begin() + 1, values.end());
-	auto& terminal = dones;
+	// The recurrence is sequential, so it runs on the CPU regardless of where the inputs are
+	auto fnToCPU = [](torch::Tensor& t) {
+		t = t.to(torch::kCPU, torch::kFloat32).contiguous();
+		return t.data_ptr<float>();
+	};
+
+	const float* rewsData = fnToCPU(rews);
+	const float* terminal = fnToCPU(dones);
+	const float* truncData = fnToCPU(truncated);
+	const float* valuesData = fnToCPU(values);
+	const float* nextValuesData = fnToCPU(nextValues);
 
 	float returnScale = 1 / returnStd;
 	if (isnan(returnScale))
 		returnScale = 0;
 
+	int64_t nReturns = rews.size(0);
+	outAdvantages = torch::empty({ nReturns });
+	outReturns = torch::empty({ nReturns });
+	float* adv = outAdvantages.data_ptr<float>();
+	float* returns = outReturns.data_ptr<float>();
+
 	float lastGAE_LAM = 0;
-	int nReturns = rews.size();
-	FList adv = FList(nReturns);
-	FList returns = FList(nReturns);
 	float lastReturn = 0;
 
-	for (int step = nReturns - 1; step >= 0; step--) {
+	for (int64_t step = nReturns - 1; step >= 0; step--) {
 		float done = 1 - terminal[step];
-		float trunc = 1 - truncated[step];
+		float trunc = 1 - truncData[step];
 
 		float norm_rew;
 		if (returnStd != 0) {
-			norm_rew = rews[step] * returnScale;
+			norm_rew = rewsData[step] * returnScale;
 			if (clipRange > 0)
 				norm_rew = RS_CLAMP(norm_rew, -clipRange, clipRange);
 		} else {
-			norm_rew = rews[step];
+			norm_rew = rewsData[step];
 		}
 
-		float pred_ret = norm_rew + gamma * next_values[step] * done;
-		float delta = pred_ret - values[step];
-		float ret = rews[step] + lastReturn * gamma * done * trunc;
+		float pred_ret = norm_rew + gamma * nextValuesData[step] * done;
+		float delta = pred_ret - valuesData[step];
+		float ret = rewsData[step] + lastReturn * gamma * done * trunc;
 		returns[step] = ret;
 		lastReturn = ret;
 		lastGAE_LAM = delta + gamma * lambda * done * trunc * lastGAE_LAM;
 		adv[step] = lastGAE_LAM;
 	}
 
-	outAdvantages = torch::tensor(adv);
-	auto outValuesList = FList(values.size() - 1);
-	for (int i = 0; i < values.size() - 1; i++)
-		outValuesList[i] = values[i] + adv[i];
-
-	outValues = torch::tensor(outValuesList);
-	outReturns = returns;
+	outValues = values + outAdvantages;
 }
 
 torch::Tensor RLGPC::TorchFuncs::ConcatSafe(torch::Tensor a, torch::Tensor b) {
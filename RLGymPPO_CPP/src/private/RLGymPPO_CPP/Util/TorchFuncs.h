@@ -6,9 +6,12 @@
 namespace RLGPC {
 	// https://github.com/AechPro/rlgym-ppo/blob/main/rlgym_ppo/util/torch_functions.py
 	namespace TorchFuncs {
+		// Unlike rlgym-ppo, the value of each step's next state is passed separately in nextValues,
+		//	so steps at the end of a truncated trajectory bootstrap from their own next state
+		// All outputs are CPU tensors
 		void ComputeGAE(
-			const FList& rews, const FList& dones, const FList& truncated, const FList& values,
-			torch::Tensor& outAdvantages, torch::Tensor& outValues, FList& outReturns,
+			torch::Tensor rews, torch::Tensor dones, torch::Tensor truncated, torch::Tensor values, torch::Tensor nextValues,
+			torch::Tensor& outAdvantages, torch::Tensor& outValues, torch::Tensor& outReturns,
 			float gamma = 0.99f, float lambda = 0.95f, float returnStd = 0, float clipRange = 10
 		);
 
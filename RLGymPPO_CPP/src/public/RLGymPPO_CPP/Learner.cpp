@@ -1,10 +1,14 @@
 #include "Learner.h"
 
 #include "../../private/RLGymPPO_CPP/Util/SkillTracker.h"
+#include "../../private/RLGymPPO_CPP/Util/RunningStatJSON.h"
+#include "Util/AutoTuner.h"
+#include "Util/BCDataset.h"
 
 #include <RLGymPPO_CPP/PPO/PPOLearner.h>
 #include <RLGymPPO_CPP/PPO/ExperienceBuffer.h>
 #include <RLGymPPO_CPP/Threading/ThreadAgentManager.h>
+#include <RLGymPPO_CPP/Threading/CollectionWorkers.h>
 
 #include <torch/torch.h>
 #include <torch/cuda.h>
@@ -22,23 +26,13 @@
 #include <string>
 #include <vector>
 #include <ctime>
+#include <thread>
+#include <chrono>
 
 using namespace nlohmann;
 
 namespace RLGPC {
 
-    template <typename T>
-    json MakeJSONArray(const std::vector<T>& list) {
-        json result = json::array();
-        for (const T& v : list) {
-            if (std::isnan(v)) {
-                continue;
-            }
-            result.push_back(v);
-        }
-        return result;
-    }
-
     void DisplayReport(const Report& report) {
         constexpr const char* REPORT_DATA_ORDER[] = {
             "Average Episode Reward",
@@ -96,6 +90,7 @@ namespace RLGPC {
         metricSender(nullptr),
         renderSender(nullptr),
         skillTracker(nullptr),
+        workerServer(nullptr),
         totalTimesteps(0),
         totalEpochs(0),
         returnStats(1)
@@ -105,9 +100,6 @@ namespace RLGPC {
         if (config.timestepsPerSave == 0)
             config.timestepsPerSave = config.timestepsPerIteration;
 
-        if (config.standardizeOBS)
-            RG_ERR_CLOSE("LearnerConfig.standardizeOBS has not yet been implemented, sorry");
-
         if (config.renderMode && !config.renderDuringTraining) {
             config.numThreads = config.numGamesPerThread = 1;
             config.sendMetrics = false;
@@ -115,6 +107,18 @@ namespace RLGPC {
             config.timestepsPerIteration = INT_MAX;
         }
 
+        if (config.collectionWorkerIndex >= 0) {
+            // The learner process takes care of these
+            config.sendMetrics = false;
+            config.checkpointLoadFolder.clear();
+            config.checkpointSaveFolder.clear();
+            config.skillTrackerConfig.enabled = false;
+            config.autoTunerConfig.profilePath.clear();
+
+            // The learner's opponent pool isn't sent to workers
+            config.opponentPoolFraction = 0;
+        }
+
         if (config.saveFolderAddUnixTimestamp && !config.checkpointSaveFolder.empty())
             config.checkpointSaveFolder += "-" + std::to_string(std::time(0));
 
@@ -157,6 +161,26 @@ namespace RLGPC {
             delete envCreateResult.match;
         }
 
+        if (!config.autoTunerConfig.profilePath.empty() && !config.renderMode) {
+            auto& profilePath = config.autoTunerConfig.profilePath;
+
+            AutoTuneProfile profile;
+            if (std::filesystem::exists(profilePath) && !config.autoTunerConfig.forceRetune) {
+                RG_LOG("Loading auto-tune profile from " << profilePath << "...");
+                profile = AutoTuneProfile::Load(profilePath);
+            }
+            else {
+                profile = RunAutoTune(envCreateFunc, config);
+                profile.Save(profilePath);
+                RG_LOG("Saved auto-tune profile to " << profilePath);
+            }
+
+            profile.ApplyTo(config);
+
+            // Tuning builds its own models from the same seed, re-seed so our models get the same initialization as without tuning
+            torch::manual_seed(config.randomSeed);
+        }
+
         expBuffer = new ExperienceBuffer(config.expBufferSize, config.randomSeed, device);
         ppo = new PPOLearner(obsSize, actionAmount, config.ppo, device);
 
@@ -167,7 +191,12 @@ namespace RLGPC {
             device
         );
 
+        if (config.standardizeOBS)
+            agentMgr->InitOBSStandardization(obsSize, config.obsClipRange, config.stepsPerObsStatsInc);
+
         agentMgr->CreateAgents(envCreateFunc, config.numThreads, config.numGamesPerThread);
+        agentMgr->opponentPoolFraction = config.opponentPoolFraction;
+        agentMgr->maxOpponentVersions = config.maxOpponentVersions;
 
         if (config.renderMode) {
             renderSender = new RenderSender();
@@ -181,11 +210,26 @@ namespace RLGPC {
                 config.skillTrackerConfig.envCreateFunc = envCreateFunc;
 
             skillTracker = new SkillTracker(config.skillTrackerConfig, renderSender);
+            skillTracker->obsStandardizer = agentMgr->obsStandardizer;
         }
 
         if (!config.checkpointLoadFolder.empty())
             Load();
 
+        if (config.numCollectionWorkers > 0 && config.collectionWorkerIndex < 0) {
+            uint64_t numPolicyParams = 0;
+            for (auto& param : ppo->policy->parameters())
+                numPolicyParams += param.numel();
+
+            // Workers can collect a bit more than they were asked to, like the local agents
+            workerServer = new CollectionWorkerServer(
+                config.collectionWorkerShmName, config.numCollectionWorkers, config.collectionWorkerSlots,
+                static_cast<int>(config.collectionWorkerChunkSteps * 1.5f), obsSize, numPolicyParams,
+                config.standardizeOBS, config.collectionWorkerTimeout
+            );
+            workerServer->maxPolicyLag = config.collectionWorkerMaxPolicyLag;
+        }
+
         if (config.sendMetrics) {
             metricSender = new MetricSender(config.metricsProjectName, config.metricsGroupName, config.metricsRunName, runID);
             if (!runID.empty())
@@ -206,24 +250,22 @@ namespace RLGPC {
         j["epoch"] = totalEpochs;
 
         if (skillTracker) {
+            auto curRating = skillTracker->GetCurRating();
             if (skillTracker->config.perModeRatings) {
                 json ratings = {};
-                for (auto& pair : skillTracker->curRating.data)
+                for (auto& pair : curRating.data)
                     ratings[pair.first] = pair.second;
                 j["skill_rating"] = ratings;
             }
             else {
-                j["skill_rating"] = skillTracker->curRating.data[""];
+                j["skill_rating"] = curRating.data[""];
             }
         }
 
-        auto& rrs = j["reward_running_stats"];
-        {
-            rrs["mean"] = MakeJSONArray(returnStats.runningMean);
-            rrs["var"] = MakeJSONArray(returnStats.runningVariance);
-            rrs["shape"] = returnStats.shape;
-            rrs["count"] = returnStats.count;
-        }
+        j["reward_running_stats"] = RunningStatToJSON(returnStats);
+
+        if (config.standardizeOBS)
+            j["obs_running_stats"] = RunningStatToJSON(agentMgr->obsStats);
 
         if (config.sendMetrics && metricSender)
             j["run_id"] = metricSender->curRunID;
@@ -248,12 +290,20 @@ namespace RLGPC {
             skillTracker->curRating = skillTracker->LoadRatingSet(j["skill_rating"]);
         }
 
-        auto& rrs = j["reward_running_stats"];
-        {
-            returnStats = WelfordRunningStat(rrs["shape"]);
-            returnStats.runningMean = rrs["mean"].get<std::vector<double>>();
-            returnStats.runningVariance = rrs["var"].get<std::vector<double>>();
-            returnStats.count = rrs["count"];
+        returnStats = RunningStatFromJSON(j["reward_running_stats"]);
+
+        if (config.standardizeOBS) {
+            if (j.contains("obs_running_stats")) {
+                WelfordRunningStat obsStats = RunningStatFromJSON(j["obs_running_stats"]);
+                if (obsStats.shape != obsSize)
+                    RG_ERR_CLOSE(ERROR_PREFIX << "Saved observation stats have a size of " << obsStats.shape << ", but the observation size is " << obsSize);
+
+                agentMgr->obsStats = obsStats;
+                agentMgr->UpdateOBSStandardization();
+            }
+            else {
+                RG_LOG(ERROR_PREFIX << "WARNING: standardizeOBS is enabled, but no observation stats were saved, they will start from scratch");
+            }
         }
 
         if (j.contains("run_id"))
@@ -262,11 +312,7 @@ namespace RLGPC {
 
     constexpr const char* STATS_FILE_NAME = "RUNNING_STATS.json";
 
-    void Learner::Save() {
-        if (config.checkpointSaveFolder.empty())
-            RG_ERR_CLOSE("Learner::Save(): Cannot save because config.checkpointSaveFolder is not set");
-
-        std::filesystem::path saveFolder = config.checkpointSaveFolder / std::to_string(totalTimesteps);
+    void Learner::SaveTo(std::filesystem::path saveFolder) {
         std::error_code ec;
         std::filesystem::create_directories(saveFolder, ec);
         if (ec)
@@ -274,7 +320,15 @@ namespace RLGPC {
 
         SaveStats(saveFolder / STATS_FILE_NAME);
         ppo->SaveTo(saveFolder);
+    }
 
+    void Learner::Save() {
+        if (config.checkpointSaveFolder.empty())
+            RG_ERR_CLOSE("Learner::Save(): Cannot save because config.checkpointSaveFolder is not set");
+
+        SaveTo(config.checkpointSaveFolder / std::to_string(totalTimesteps));
+
+        std::error_code ec;
         if (config.checkpointsToKeep != -1) {
             int numCheckpoints = 0;
             int64_t lowestCheckpointTS = std::numeric_limits<int64_t>::max();
@@ -364,7 +418,7 @@ namespace RLGPC {
                     }
 
                     if (bestTimesteps != -1 && bestTimesteps >= targetTimesteps - maxAcceptableOverage) {
-
+                        // Loaded now, as old checkpoints can be deleted by Save() while training
                         auto oldPolicy = ppo->LoadAdditionalPolicy(config.checkpointLoadFolder / std::to_string(bestTimesteps));
 
                         if (oldPolicy) {
@@ -373,28 +427,117 @@ namespace RLGPC {
                                 skillTracker->LoadRatingSet(bestRating)
                             );
                         }
-
                     }
                 }
             }
         }
     }
 
+    void Learner::Pretrain(const PretrainConfig& pretrainConfig) {
+        constexpr const char* ERROR_PREFIX = "Learner::Pretrain(): ";
+
+        BCDatasetReader dataset = BCDatasetReader(
+            pretrainConfig.datasetPath, pretrainConfig.blockRows, pretrainConfig.shuffleBufferRows, config.randomSeed
+        );
+
+        if (dataset.header.obsSize != obsSize)
+            RG_ERR_CLOSE(ERROR_PREFIX << "Dataset observation size (" << dataset.header.obsSize << ") does not match the environment's (" << obsSize << ")");
+
+        if (config.standardizeOBS)
+            RG_LOG("WARNING: Pretraining uses the current observation statistics, which it does not update");
+
+        bool trainCritic = dataset.header.hasReturns && pretrainConfig.criticLR != 0;
+        float prevPolicyLR = ppo->config.policyLR, prevCriticLR = ppo->config.criticLR;
+        ppo->UpdateLearningRates(pretrainConfig.policyLR, trainCritic ? pretrainConfig.criticLR : 0);
+
+        RG_LOG("Pretraining on " << dataset.numRows << " samples from " << pretrainConfig.datasetPath << "...");
+
+        OBSStandardizer::Reader obsStandardizerReader = {};
+        FList obs, returns;
+        IList actions;
+        for (int epoch = 0; epoch < pretrainConfig.epochs; epoch++) {
+            dataset.StartEpoch();
+
+            Report report = {};
+            Timer epochTimer = {};
+            uint64_t numSamples = 0;
+            while (dataset.NextBatch(pretrainConfig.batchSize, obs, actions, returns)) {
+                int64_t batchSize = actions.size();
+
+                auto obsTensor = torch::from_blob(obs.data(), { batchSize, obsSize }).clone();
+                if (agentMgr->obsStandardizer)
+                    agentMgr->obsStandardizer->Apply(obsTensor, obsStandardizerReader);
+
+                auto actionsTensor = torch::from_blob(actions.data(), { batchSize }, torch::kInt32).clone();
+
+                torch::Tensor returnsTensor = {};
+                if (trainCritic)
+                    returnsTensor = torch::from_blob(returns.data(), { batchSize }).clone();
+
+                try {
+                    ppo->LearnSupervised(obsTensor, actionsTensor, returnsTensor, report);
+                } catch (std::exception& e) {
+                    RG_ERR_CLOSE("Exception during PPOLearner::LearnSupervised(): " << e.what());
+                }
+
+                numSamples += batchSize;
+            }
+
+            Report epochReport = {};
+            epochReport["BC Epoch"] = epoch + 1;
+            epochReport["BC Policy Loss"] = report.GetAvg("BC Policy Loss");
+            epochReport["BC Accuracy"] = report.GetAvg("BC Accuracy");
+            if (trainCritic)
+                epochReport["BC Value Loss"] = report.GetAvg("BC Value Loss");
+            epochReport["BC Samples/Second"] = numSamples / epochTimer.Elapsed();
+            epochReport["Cumulative Model Updates"] = ppo->cumulativeModelUpdates;
+
+            RG_LOG("Pretrain epoch " << (epoch + 1) << "/" << pretrainConfig.epochs << ":");
+            for (auto& pair : epochReport.data)
+                RG_LOG(" " << epochReport.SingleToString(pair.first, true));
+
+            if (metricSender)
+                metricSender->Send(epochReport);
+
+            if (!config.checkpointSaveFolder.empty()) {
+                if (epoch == pretrainConfig.epochs - 1) {
+                    Save();
+                } else if (pretrainConfig.saveEveryEpoch) {
+                    // Pretraining doesn't advance totalTimesteps, so these can't be timestep-numbered like normal checkpoints
+                    // The name can't start with a number, so that Load() and the checkpoint limit ignore them
+                    SaveTo(config.checkpointSaveFolder / ("pretrain_epoch_" + std::to_string(epoch + 1)));
+                }
+            }
+        }
+
+        ppo->UpdateLearningRates(prevPolicyLR, prevCriticLR);
+    }
+
     void Learner::Learn() {
 
+        if (config.collectionWorkerIndex >= 0) {
+            RunCollectionWorker();
+            return;
+        }
+
         agentMgr->SetStepCallback(stepCallback);
         agentMgr->StartAgents();
 
+        if (workerServer)
+            workerServer->PublishPolicy(ppo->policy, config.standardizeOBS ? &agentMgr->obsStats : NULL);
+
         auto device = ppo->device;
 
         int64_t tsSinceSave = 0;
+        int64_t tsSinceOpponentVersion = 0;
         Timer epochTimer;
         while (totalTimesteps < config.timestepLimit || config.timestepLimit == 0) {
             Report report = {};
 
             agentMgr->SetStepCallback(stepCallback);
 
-            GameTrajectory timesteps = agentMgr->CollectTimesteps(config.timestepsPerIteration);
+            GameTrajectory timesteps;
+            CollectTimesteps(timesteps, report);
             double relCollectionTime = epochTimer.Elapsed();
             uint64_t timestepsCollected = timesteps.size;
 
@@ -446,6 +589,17 @@ namespace RLGPC {
                 totalEpochs += config.ppo.epochs;
             }
 
+            if (workerServer)
+                workerServer->PublishPolicy(ppo->policy, config.standardizeOBS ? &agentMgr->obsStats : NULL);
+
+            if (config.opponentPoolFraction > 0) {
+                tsSinceOpponentVersion += timestepsCollected;
+                if (agentMgr->opponentPool.empty() || tsSinceOpponentVersion >= config.timestepsPerOpponentVersion) {
+                    agentMgr->AddOpponentVersion(ppo->policy);
+                    tsSinceOpponentVersion = 0;
+                }
+            }
+
 #ifdef RG_CUDA_SUPPORT
             if (ppo->device.is_cuda())
                 c10::cuda::CUDACachingAllocator::emptyCache();
@@ -463,10 +617,7 @@ namespace RLGPC {
                     skillTracker->config.stepCallback = stepCallback;
 
                 skillTracker->RunGames(ppo->policy, timestepsCollected);
-                for (auto& pair : skillTracker->curRating.data) {
-                    std::string metricName = "Skill Rating" + (pair.first.empty() ? "" : " " + pair.first);
-                    report[metricName] = pair.second;
-                }
+                skillTracker->GetMetrics(report);
             }
 
             agentMgr->GetMetrics(report);
@@ -522,53 +673,149 @@ namespace RLGPC {
             agentMgr->ResetMetrics();
         }
 
+        if (skillTracker)
+            skillTracker->Stop();
+
         agentMgr->StopAgents();
     }
 
-    void Learner::AddNewExperience(GameTrajectory& gameTraj, Report& report) {
-        RG_NOGRAD;
+    void Learner::CollectTimesteps(GameTrajectory& timestepsOut, Report& report) {
+        if (!workerServer) {
+            timestepsOut = agentMgr->CollectTimesteps(config.timestepsPerIteration);
+            return;
+        }
 
-        gameTraj.RemoveCapacity();
-        auto& trajData = gameTraj.data;
+        // Local agents keep collecting while chunks from the workers come in
+        std::vector<GameTrajectory> workerTrajs;
+        uint64_t workerTimesteps = 0;
+        WelfordRunningStat* obsStats = config.standardizeOBS ? &agentMgr->obsStats : NULL;
+        while (true) {
+            workerTimesteps += workerServer->Receive(workerTrajs, obsStats);
+            if (agentMgr->GetStepsCollected() + workerTimesteps >= config.timestepsPerIteration)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Also updates the OBS standardization, which now includes the workers' stats
+        timestepsOut = agentMgr->CollectTimesteps(0);
+
+        try {
+            if (!workerTrajs.empty())
+                timestepsOut.MultiAppend(workerTrajs);
+        }
+        catch (const std::exception& e) {
+            RG_ERR_CLOSE("Exception concatenating worker timesteps: " << e.what());
+        }
+
+        report["Worker Timesteps Collected"] = workerTimesteps;
+        report["Collection Workers Alive"] = workerServer->GetNumAliveWorkers();
+
+        auto& lagStats = workerServer->lagStats;
+        report["Worker Policy Lag Avg"] = lagStats.GetAvgLag();
+        report["Worker Policy Lag Max"] = lagStats.maxLag;
+        report["Worker Timesteps Dropped"] = lagStats.numDroppedSteps;
+        lagStats = {};
+    }
 
-        size_t count = trajData.actions.size(0);
-        size_t valPredCount = count + 1;
+    void Learner::RunCollectionWorker() {
+        CollectionWorkerClient client = CollectionWorkerClient(
+            config.collectionWorkerShmName, config.collectionWorkerIndex, config.collectionWorkerTimeout
+        );
 
-        torch::Tensor valPredsTensor = torch::zeros({ static_cast<int64_t>(valPredCount) });
+        WelfordRunningStat* obsStats = config.standardizeOBS ? &agentMgr->obsStats : NULL;
 
-        for (size_t i = 0; i < valPredCount; i += ppo->config.miniBatchSize) {
-            size_t start = i;
-            size_t end = std::min(i + ppo->config.miniBatchSize, valPredCount);
-            size_t sliceEnd = (end > count) ? count : end;
+        // Returns false if the learner has not published a newer policy
+        auto fnUpdatePolicy = [&]() {
+            // Only inference that locks inferMutex is blocked, same as when the learner updates the policy while collecting
+            std::lock_guard<std::mutex> lock(agentMgr->inferMutex);
+            if (!client.TryReadPolicy(ppo->policy, obsStats))
+                return false;
 
-            torch::Tensor statesPart = trajData.states.slice(0, start, sliceEnd);
+            // The learner's stats already include everything we sent so far
+            if (obsStats)
+                agentMgr->UpdateOBSStandardization();
+            return true;
+        };
 
-            if (end == valPredCount) {
-                auto finalNextState = torch::unsqueeze(trajData.nextStates[count - 1], 0);
-                statesPart = torch::cat({ statesPart, finalNextState });
+        while (!fnUpdatePolicy()) {
+            if (!client.IsLearnerAlive()) {
+                RG_LOG("Collection worker " << config.collectionWorkerIndex << ": The learner stopped before publishing a policy");
+                return;
             }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
 
-            auto valPredsPart = ppo->valueNet->Forward(statesPart.to(ppo->device, true)).cpu().flatten();
-            RG_ASSERT(valPredsPart.size(0) == static_cast<int64_t>(end - start));
-            valPredsTensor.slice(0, start, end).copy_(valPredsPart, true);
+        agentMgr->SetStepCallback(stepCallback);
+        agentMgr->StartAgents();
+
+        uint64_t timestepsSent = 0;
+        while (true) {
+            GameTrajectory timesteps = agentMgr->CollectTimesteps(config.collectionWorkerChunkSteps);
+            if (!client.Send(timesteps, obsStats ? &agentMgr->lastCollectedObsStats : NULL))
+                break;
+
+            timestepsSent += timesteps.size;
+            agentMgr->ResetMetrics();
+            fnUpdatePolicy();
         }
 
-        FList valPreds = TENSOR_TO_FLIST(valPredsTensor);
+        RG_LOG("Collection worker " << config.collectionWorkerIndex << ": The learner stopped (" << timestepsSent << " timesteps sent), exiting");
+        agentMgr->StopAgents();
+    }
+
+    void Learner::AddNewExperience(GameTrajectory& gameTraj, Report& report) {
+        RG_NOGRAD;
+
+        gameTraj.RemoveCapacity();
+        auto& trajData = gameTraj.data;
+
+        int64_t count = trajData.actions.size(0);
+        auto device = ppo->device;
+
+        // Every trajectory ends with a done or truncated step
+        // Those are the only steps whose next state isn't the state of the following step, so they are the only next states we need values for
+        torch::Tensor endIndices = torch::nonzero((trajData.dones + trajData.truncateds) > 0).flatten();
+        torch::Tensor endNextStates = trajData.nextStates.index_select(0, endIndices);
+
+        // Predictions are written straight into these, on the learner's device
+        torch::Tensor valPreds = torch::empty({ count }, device);
+        torch::Tensor endValPreds = torch::empty({ endIndices.size(0) }, device);
+
+        auto fnPredictValues = [&](const torch::Tensor& states, torch::Tensor& out) {
+            int64_t amount = states.size(0);
+            for (int64_t start = 0; start < amount; start += ppo->config.miniBatchSize) {
+                int64_t end = std::min(start + ppo->config.miniBatchSize, amount);
+                auto valPredsPart = ppo->valueNet->Forward(states.slice(0, start, end).to(device, true)).flatten();
+                out.slice(0, start, end).copy_(valPredsPart, true);
+            }
+        };
+        fnPredictValues(trajData.states, valPreds);
+        fnPredictValues(endNextStates, endValPreds);
+
+        torch::Tensor nextValPreds = torch::zeros({ count }, device);
+        if (count > 1)
+            nextValPreds.slice(0, 0, count - 1).copy_(valPreds.slice(0, 1, count));
+        nextValPreds.index_copy_(0, endIndices.to(device), endValPreds);
+
+        // Only sync with the device once everything has been predicted
+        torch::Tensor valPredsCPU = valPreds.cpu();
+        torch::Tensor nextValPredsCPU = nextValPreds.cpu();
 
 #ifdef RG_CUDA_SUPPORT
-        if (ppo->device.is_cuda())
+        if (device.is_cuda())
             c10::cuda::CUDACachingAllocator::emptyCache();
 #endif
 
         float retStd = (config.standardizeReturns ? returnStats.GetSTD()[0] : 1.0f);
 
-        torch::Tensor advantages, valueTargets;
-        FList returns;
+        torch::Tensor advantages, valueTargets, returns;
         TorchFuncs::ComputeGAE(
-            TENSOR_TO_FLIST(trajData.rewards),
-            TENSOR_TO_FLIST(trajData.dones),
-            TENSOR_TO_FLIST(trajData.truncateds),
-            valPreds,
+            trajData.rewards,
+            trajData.dones,
+            trajData.truncateds,
+            valPredsCPU,
+            nextValPredsCPU,
             advantages,
             valueTargets,
             returns,
@@ -578,18 +825,15 @@ namespace RLGPC {
             config.rewardClipRange
         );
 
-        float avgRet = 0.0f;
-        for (const float& f : returns)
-            avgRet += std::abs(f);
-        avgRet /= static_cast<float>(returns.size());
-        report["Avg Return"] = avgRet / retStd;
-
+        report["Avg Return"] = returns.abs().mean().item<float>() / retStd;
         report["Avg Advantage"] = advantages.abs().mean().item<float>();
         report["Avg Val Target"] = valueTargets.abs().mean().item<float>();
 
         if (config.standardizeReturns) {
-            size_t numToIncrement = std::min(static_cast<size_t>(config.maxReturnsPerStatsInc), returns.size());
-            returnStats.Increment(returns, numToIncrement);
+            int64_t numToIncrement = count;
+            if (config.maxReturnsPerStatsInc > 0)
+                numToIncrement = std::min(static_cast<int64_t>(config.maxReturnsPerStatsInc), numToIncrement);
+            returnStats.IncrementBatch(returns.data_ptr<float>(), numToIncrement);
         }
 
         ExperienceTensors expTensors{
@@ -632,12 +876,14 @@ namespace RLGPC {
     }
 
     Learner::~Learner() {
+        // The skill tracker uses the agent manager's OBS standardizer and the render sender
+        delete skillTracker;
+        delete workerServer;
         delete ppo;
         delete agentMgr;
         delete expBuffer;
         delete metricSender;
         delete renderSender;
-        delete skillTracker;
         pybind11::finalize_interpreter();
     }
 
@@ -5,6 +5,7 @@
 #include "Util/MetricSender.h"
 #include "Util/RenderSender.h"
 #include "LearnerConfig.h"
+#include "Util/PretrainConfig.h"
 
 namespace RLGPC {
 
@@ -24,6 +25,9 @@ namespace RLGPC {
 
         struct SkillTracker* skillTracker;
 
+        // Only set if this is a learner with collection workers, see LearnerConfig::numCollectionWorkers
+        class CollectionWorkerServer* workerServer;
+
         int obsSize;
         int actionAmount;
 
@@ -37,14 +41,26 @@ namespace RLGPC {
 
         Learner(EnvCreateFn envCreateFunc, LearnerConfig config);
         void Learn();
+
+        // Called by Learn() when this is a collection worker, see LearnerConfig::collectionWorkerIndex
+        void RunCollectionWorker();
+
+        // Trains the policy (and the critic, if the dataset has returns) to imitate a BC dataset, see PretrainConfig
+        // Saves normal checkpoints, so learning can continue from them
+        void Pretrain(const PretrainConfig& pretrainConfig);
         void AddNewExperience(class GameTrajectory& gameTraj, Report& report);
 
+        // Collects timesteps for an iteration from the local agents, and from collection workers if there are any
+        void CollectTimesteps(class GameTrajectory& timestepsOut, Report& report);
+
         void UpdateLearningRates(float policyLR, float criticLR);
 
         std::vector<Report> GetAllGameMetrics();
 
         void Save();
         void Load();
+        // Saves a checkpoint to this exact folder (Save() picks the folder from the timesteps, and deletes old checkpoints)
+        void SaveTo(std::filesystem::path saveFolder);
         void SaveStats(std::filesystem::path path);
         void LoadStats(std::filesystem::path path);
 
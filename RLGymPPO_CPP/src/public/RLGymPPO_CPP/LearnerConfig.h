@@ -2,6 +2,7 @@
 #include "Lists.h"
 #include "PPO/PPOLearnerConfig.h"
 #include <RLGymPPO_CPP/Util/SkillTrackerConfig.h>
+#include <RLGymPPO_CPP/Util/AutoTunerConfig.h>
 
 namespace RLGPC {
 	enum class LearnerDeviceType {
@@ -32,9 +33,14 @@ namespace RLGPC {
 		int64_t expBufferSize = 100 * 1000;
 		int64_t timestepsPerIteration = 50 * 1000;
 		bool standardizeReturns = true;
-		bool standardizeOBS = false; // TODO: Implement
-		int maxReturnsPerStatsInc = 150;
-		int stepsPerObsStatsInc = 5;
+		// Standardize observations with running statistics before they are given to the policy/critic
+		// The statistics are saved with checkpoints, use InferUnit::LoadOBSStats() to apply them when deploying
+		bool standardizeOBS = false;
+		float obsClipRange = 5; // Clip range for standardized observations, set 0 to disable
+		// Maximum number of returns from each iteration to add to the return statistics, set to 0 to use all of them
+		// rlgym-ppo uses 150, but merging in the whole batch is cheap
+		int maxReturnsPerStatsInc = 0;
+		int stepsPerObsStatsInc = 5; // Observations are added to the stats every this many steps
 
 		// Actions with the highest probability are always chosen, instead of being more likely
 		// This will make your bot play better, but is horrible for learning
@@ -45,6 +51,29 @@ namespace RLGPC {
 		// Note that, once the learning phase completes and the policy is updated, these additional steps are from the old policy
 		bool collectionDuringLearn = false;
 
+		// Fraction of collection games where the opponent team is controlled by a past version of the policy, instead of mirror self-play
+		// Only the current policy's players are learned from, so opponent pool games collect fewer steps
+		float opponentPoolFraction = 0;
+		int64_t timestepsPerOpponentVersion = 5 * 1000 * 1000; // Timesteps between adding the current policy to the opponent pool
+		int maxOpponentVersions = 8; // Maximum amount of versions in the opponent pool, the oldest versions are removed first
+
+		// Amount of collection worker processes that can send timesteps to this learner through shared memory, set to 0 to disable
+		// Workers are separate runs of your program with the same config, but with collectionWorkerIndex set (each to a different index)
+		// They can be started after the learner, and can crash or be restarted at any time
+		// Their timesteps count towards timestepsPerIteration, along with those of the learner's own numThreads threads (which can be 0)
+		int numCollectionWorkers = 0;
+		// If set (0 to numCollectionWorkers-1), Learn() only runs games with the learner's latest policy and sends the timesteps to the learner
+		// Checkpoints, metrics, and the skill tracker are left to the learner
+		// Workers don't receive the opponent pool (see opponentPoolFraction), so all of their games are mirror self-play
+		int collectionWorkerIndex = -1;
+		std::string collectionWorkerShmName = "rlgymppo_cpp_collection"; // Must be different for each learner running on the same machine
+		int collectionWorkerChunkSteps = 10 * 1000; // Timesteps workers collect before sending them
+		int collectionWorkerSlots = 4; // Amount of chunks each worker can have waiting for the learner before it has to wait
+		float collectionWorkerTimeout = 10; // Seconds without a heartbeat before a worker is considered dead (or the learner, for workers)
+		// Chunks sent with a policy more than this many versions older than the learner's latest are thrown away, set to -1 to disable
+		// Chunks finished while the learner is learning are 1 version behind, like the steps from collectionDuringLearn
+		int collectionWorkerMaxPolicyLag = 1;
+
 		PPOLearnerConfig ppo = {};
 
 		float gaeLambda = 0.95f;
@@ -78,5 +107,8 @@ namespace RLGPC {
 		std::string metricsRunName = "rlgymppo-cpp-run"; // Run name for the python metrics receiver
 
 		SkillTrackerConfig skillTrackerConfig = {};
+
+		// Overrides numThreads, numGamesPerThread, ppo.miniBatchSize and ppo.learnThreads if a profile path is set
+		AutoTunerConfig autoTunerConfig = {};
 	};
 }
\ No newline at end of file
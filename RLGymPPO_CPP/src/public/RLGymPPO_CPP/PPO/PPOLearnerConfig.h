@@ -14,6 +14,10 @@ namespace RLGPC {
 		float clipRange = 0.2f;
 		int64_t miniBatchSize = 0; // Set to 0 to just use batchSize
 
+		// Number of threads to split each batch between when learning on CPU
+		// Set to 0 to use 1.5x the hardware thread count
+		int learnThreads = 0;
+
 		// Experimental, improves PPO learn speed
 		// If this causes your learning to collapse, please let me know
 		bool autocastLearn = false;
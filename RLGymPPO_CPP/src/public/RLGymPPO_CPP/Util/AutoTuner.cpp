@@ -0,0 +1,314 @@
+#include "AutoTuner.h"
+
+#include "Timer.h"
+
+#include <RLGymPPO_CPP/PPO/PPOLearner.h>
+#include <RLGymPPO_CPP/PPO/ExperienceBuffer.h>
+#include <RLGymPPO_CPP/Threading/ThreadAgentManager.h>
+#include <RLGymPPO_CPP/Util/MemoryUsage.h>
+
+#include <torch/torch.h>
+#include <torch/cuda.h>
+#include "../libsrc/json/nlohmann/json.hpp"
+
+#include <fstream>
+#include <thread>
+#include <atomic>
+
+using namespace nlohmann;
+
+namespace RLGPC {
+
+	void AutoTuneProfile::ApplyTo(LearnerConfig& config) const {
+		config.numThreads = numThreads;
+		config.numGamesPerThread = numGamesPerThread;
+		config.ppo.miniBatchSize = miniBatchSize;
+		config.ppo.learnThreads = learnThreads;
+	}
+
+	void AutoTuneProfile::Save(std::filesystem::path path) const {
+		constexpr const char* ERROR_PREFIX = "AutoTuneProfile::Save(): ";
+
+		std::ofstream fOut(path, std::ios::out | std::ios::trunc);
+		if (!fOut.good())
+			RG_ERR_CLOSE(ERROR_PREFIX << "Can't open file at " << path);
+
+		json j = {};
+		j["num_threads"] = numThreads;
+		j["num_games_per_thread"] = numGamesPerThread;
+		j["minibatch_size"] = miniBatchSize;
+		j["learn_threads"] = learnThreads;
+		j["estimated_overall_sps"] = estimatedOverallSPS;
+		j["memory_usage_gb"] = memoryUsageGB;
+
+		fOut << j.dump(4);
+	}
+
+	AutoTuneProfile AutoTuneProfile::Load(std::filesystem::path path) {
+		constexpr const char* ERROR_PREFIX = "AutoTuneProfile::Load(): ";
+
+		std::ifstream fIn(path);
+		if (!fIn.good())
+			RG_ERR_CLOSE(ERROR_PREFIX << "Can't open file at " << path);
+
+		json j = json::parse(fIn);
+
+		AutoTuneProfile result = {};
+		result.numThreads = j["num_threads"];
+		result.numGamesPerThread = j["num_games_per_thread"];
+		result.miniBatchSize = j["minibatch_size"];
+		result.learnThreads = j["learn_threads"];
+		result.estimatedOverallSPS = j["estimated_overall_sps"];
+		result.memoryUsageGB = j["memory_usage_gb"];
+		return result;
+	}
+
+	// Peak memory usage of the process during a trial, from construction until GetGB()
+	// Uses the OS's own peak where it can be reset, otherwise the memory usage is sampled on a thread
+	// Freed memory from earlier trials is given back first where possible, so it doesn't inflate the peak
+	struct TrialMemoryPeak {
+		bool exact;
+		std::atomic<bool> stopSampling = false;
+		std::atomic<uint64_t> sampledPeak = 0;
+		std::thread samplerThread;
+
+		TrialMemoryPeak() {
+			exact = ResetPeakMemoryUsage() && GetPeakMemoryUsage() > 0;
+			if (!exact) {
+				samplerThread = std::thread([this]() {
+					while (!stopSampling) {
+						sampledPeak = RS_MAX(sampledPeak.load(), GetProcessMemoryUsage());
+						std::this_thread::sleep_for(std::chrono::milliseconds(5));
+					}
+				});
+			}
+		}
+
+		double GetGB() {
+			uint64_t peak = exact ? GetPeakMemoryUsage() : RS_MAX(sampledPeak.load(), GetProcessMemoryUsage());
+			return peak / (1024.0 * 1024.0 * 1024.0);
+		}
+
+		~TrialMemoryPeak() {
+			stopSampling = true;
+			if (samplerThread.joinable())
+				samplerThread.join();
+		}
+
+		RG_NO_COPY(TrialMemoryPeak);
+	};
+
+	// Collects at least "amount" timesteps from a fresh set of agents, steps collected during warmup are thrown away
+	// memoryGBOut is the peak memory usage of the process during the trial
+	GameTrajectory RunCollectionTrial(
+		PPOLearner* ppo, ExperienceBuffer* expBuffer, EnvCreateFn envCreateFn,
+		int numThreads, int numGamesPerThread, int64_t amount, double& spsOut, double& memoryGBOut) {
+
+		TrialMemoryPeak memoryPeak = {};
+
+		auto device = ppo->device;
+		ThreadAgentManager agentMgr = ThreadAgentManager(
+			ppo->policy, ppo->policyHalf, expBuffer,
+			false, false, device.is_cpu() && torch::get_num_threads() > 1,
+			static_cast<uint64_t>(amount * 1.5f),
+			device
+		);
+
+		agentMgr.CreateAgents(envCreateFn, numThreads, numGamesPerThread);
+		agentMgr.StartAgents();
+
+		agentMgr.CollectTimesteps(RS_MAX(amount / 10, 1));
+		agentMgr.disableCollection = true;
+		agentMgr.CollectTimesteps(0);
+
+		Timer timer;
+		agentMgr.disableCollection = false;
+		GameTrajectory result = agentMgr.CollectTimesteps(amount);
+		spsOut = result.size / timer.Elapsed();
+
+		// Measure while all of the agents are still alive
+		memoryGBOut = memoryPeak.GetGB();
+
+		agentMgr.StopAgents();
+		return result;
+	}
+
+	AutoTuneProfile RunAutoTune(EnvCreateFn envCreateFn, const LearnerConfig& config) {
+		constexpr const char* ERROR_PREFIX = "RunAutoTune(): ";
+
+		auto& tunerConfig = config.autoTunerConfig;
+
+		if (RocketSim::GetStage() != RocketSimStage::INITIALIZED)
+			RocketSim::Init("collision_meshes", true);
+
+		torch::manual_seed(config.randomSeed);
+		torch::set_num_threads(1);
+
+		// If CUDA was requested but isn't available, the learner will report it, so just fall back to CPU here
+		torch::Device device = torch::kCPU;
+		if (config.deviceType != LearnerDeviceType::CPU && torch::cuda::is_available())
+			device = torch::kCUDA;
+
+		int obsSize, actionAmount;
+		{
+			auto envCreateResult = envCreateFn();
+			auto obsSet = envCreateResult.gym->Reset();
+			obsSize = obsSet[0].size();
+			actionAmount = envCreateResult.match->actionParser->GetActionAmount();
+			delete envCreateResult.gym;
+			delete envCreateResult.match;
+		}
+
+		PPOLearner ppo = PPOLearner(obsSize, actionAmount, config.ppo, device);
+		ExperienceBuffer expBuffer = ExperienceBuffer(config.ppo.batchSize, config.randomSeed, device);
+
+		float maxMemoryGB = tunerConfig.maxMemoryGB;
+
+		AutoTuneProfile result = {};
+		result.numThreads = config.numThreads;
+		result.numGamesPerThread = config.numGamesPerThread;
+		result.miniBatchSize = config.ppo.miniBatchSize;
+		result.learnThreads = config.ppo.learnThreads;
+
+		RG_LOG("Auto-tuning collection (device: " << device.str() << ")...");
+		IList numThreadsOptions = tunerConfig.numThreadsOptions.empty() ? IList{ config.numThreads } : tunerConfig.numThreadsOptions;
+		IList numGamesOptions = tunerConfig.numGamesPerThreadOptions.empty() ? IList{ config.numGamesPerThread } : tunerConfig.numGamesPerThreadOptions;
+
+		double bestCollectSPS = 0;
+		for (int numThreads : numThreadsOptions) {
+			for (int numGames : numGamesOptions) {
+				double sps, memoryGB;
+				RunCollectionTrial(&ppo, &expBuffer, envCreateFn, numThreads, numGames, tunerConfig.trialTimesteps, sps, memoryGB);
+
+				RG_LOG(" > " << numThreads << " threads x " << numGames << " games: " << static_cast<int64_t>(sps) << " steps/second, " << memoryGB << "GB");
+				if (maxMemoryGB > 0 && memoryGB > maxMemoryGB) {
+					RG_LOG(" > > Rejected (above memory cap of " << maxMemoryGB << "GB)");
+					continue;
+				}
+
+				if (sps > bestCollectSPS) {
+					bestCollectSPS = sps;
+					result.numThreads = numThreads;
+					result.numGamesPerThread = numGames;
+					result.memoryUsageGB = memoryGB;
+				}
+			}
+		}
+
+		if (bestCollectSPS == 0)
+			RG_ERR_CLOSE(ERROR_PREFIX << "Every collection trial exceeded the memory cap of " << maxMemoryGB << "GB");
+
+		RG_LOG("Auto-tuning learning...");
+		{
+			// Fill the buffer with one batch of real observations
+			// The values and advantages don't affect the learn time, so they are just filler
+			double sps, memoryGB;
+			GameTrajectory traj = RunCollectionTrial(
+				&ppo, &expBuffer, envCreateFn, result.numThreads, result.numGamesPerThread, config.ppo.batchSize, sps, memoryGB
+			);
+			traj.RemoveCapacity();
+			auto& trajData = traj.data;
+			int64_t count = trajData.actions.size(0);
+
+			ExperienceTensors expTensors{
+				std::move(trajData.states),
+				std::move(trajData.actions),
+				std::move(trajData.logProbs),
+				std::move(trajData.rewards),
+
+#ifdef RG_PARANOID_MODE
+				std::move(trajData.debugCounters),
+#endif
+
+				std::move(trajData.nextStates),
+				std::move(trajData.dones),
+				std::move(trajData.truncateds),
+				torch::zeros({ count }),
+				torch::randn({ count })
+			};
+			expBuffer.SubmitExperience(expTensors);
+		}
+
+		// { miniBatchSize, learnThreads }
+		std::vector<std::pair<int64_t, int>> learnOptions;
+		if (device.is_cpu()) {
+			IList learnThreadsOptions = tunerConfig.learnThreadsOptions.empty() ? IList{ config.ppo.learnThreads } : tunerConfig.learnThreadsOptions;
+			for (int learnThreads : learnThreadsOptions)
+				learnOptions.push_back({ config.ppo.miniBatchSize, learnThreads });
+		} else {
+			std::vector<int64_t> miniBatchSizeOptions = tunerConfig.miniBatchSizeOptions.empty() ? std::vector<int64_t>{ config.ppo.miniBatchSize } : tunerConfig.miniBatchSizeOptions;
+			for (int64_t miniBatchSize : miniBatchSizeOptions) {
+				int64_t realMiniBatchSize = miniBatchSize > 0 ? miniBatchSize : config.ppo.batchSize;
+				if (config.ppo.batchSize % realMiniBatchSize != 0) {
+					RG_LOG(" > Skipping minibatch size " << miniBatchSize << " (batch size is not a multiple of it)");
+					continue;
+				}
+				learnOptions.push_back({ miniBatchSize, config.ppo.learnThreads });
+			}
+		}
+
+		// Only one epoch is timed, the rest is extrapolated
+		ppo.config.epochs = 1;
+
+		// Warm up (allocations, thread pool creation, etc.)
+		{
+			Report report = {};
+			ppo.Learn(&expBuffer, report);
+		}
+
+		int64_t tsPerItr = config.timestepsPerIteration;
+		int64_t batchesPerEpoch = RS_MAX(config.expBufferSize / config.ppo.batchSize, 1);
+
+		double bestOverallSPS = 0;
+		for (auto& option : learnOptions) {
+			ppo.config.miniBatchSize = option.first > 0 ? option.first : config.ppo.batchSize;
+			ppo.config.learnThreads = option.second;
+
+			// Recreated with the new thread count on the next learn
+			delete ppo.minibatchThreadPool;
+			ppo.minibatchThreadPool = nullptr;
+
+			Report report = {};
+			TrialMemoryPeak memoryPeak = {};
+			Timer timer;
+			ppo.Learn(&expBuffer, report);
+			double batchTime = timer.Elapsed();
+			double memoryGB = memoryPeak.GetGB();
+
+			// A real iteration learns over the whole experience buffer, for every epoch
+			double learnTime = batchTime * batchesPerEpoch * config.ppo.epochs;
+			double collectTime = tsPerItr / bestCollectSPS;
+			double iterationTime = config.collectionDuringLearn ? RS_MAX(collectTime, learnTime) : (collectTime + learnTime);
+			double overallSPS = tsPerItr / iterationTime;
+
+			RG_LOG(
+				" > Minibatch size " << option.first << ", " << option.second << " learn threads: " <<
+				learnTime << "s learn time, " << static_cast<int64_t>(overallSPS) << " overall steps/second, " << memoryGB << "GB"
+			);
+			if (maxMemoryGB > 0 && memoryGB > maxMemoryGB) {
+				RG_LOG(" > > Rejected (above memory cap of " << maxMemoryGB << "GB)");
+				continue;
+			}
+
+			if (overallSPS > bestOverallSPS) {
+				bestOverallSPS = overallSPS;
+				result.miniBatchSize = option.first;
+				result.learnThreads = option.second;
+				result.memoryUsageGB = RS_MAX(result.memoryUsageGB, memoryGB);
+			}
+		}
+
+		if (bestOverallSPS == 0)
+			RG_ERR_CLOSE(ERROR_PREFIX << "No learn trial was valid (every option was skipped or exceeded the memory cap of " << maxMemoryGB << "GB)");
+
+		result.estimatedOverallSPS = bestOverallSPS;
+
+		RG_LOG(
+			"Auto-tuning done: numThreads=" << result.numThreads << ", numGamesPerThread=" << result.numGamesPerThread <<
+			", miniBatchSize=" << result.miniBatchSize << ", learnThreads=" << result.learnThreads <<
+			" (~" << static_cast<int64_t>(bestOverallSPS) << " overall steps/second)"
+		);
+
+		return result;
+	}
+}
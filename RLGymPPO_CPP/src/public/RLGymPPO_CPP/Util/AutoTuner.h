@@ -0,0 +1,27 @@
+#pragma once
+#include "../LearnerConfig.h"
+
+namespace RLGPC {
+	// Values chosen by RunAutoTune()
+	struct RG_IMEXPORT AutoTuneProfile {
+		int numThreads;
+		int numGamesPerThread;
+		int64_t miniBatchSize;
+		int learnThreads;
+
+		// Estimated Overall Steps/Second with these values, and the memory usage of the process while measuring it
+		double estimatedOverallSPS;
+		double memoryUsageGB;
+
+		void ApplyTo(LearnerConfig& config) const;
+
+		void Save(std::filesystem::path path) const;
+		static AutoTuneProfile Load(std::filesystem::path path);
+	};
+
+	// Runs short collection and learn trials over the search grid in config.autoTunerConfig,
+	//	and picks the values that give the highest Overall Steps/Second without exceeding the memory cap
+	// Collection and learning are tuned separately, since they don't run at the same time (unless collectionDuringLearn)
+	// Seeds torch's global RNG with config.randomSeed and uses it to build a policy, so re-seed after calling this if you need the seed's usual state
+	RG_IMEXPORT AutoTuneProfile RunAutoTune(EnvCreateFn envCreateFn, const LearnerConfig& config);
+}
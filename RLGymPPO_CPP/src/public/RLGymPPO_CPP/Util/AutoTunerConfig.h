@@ -0,0 +1,34 @@
+#pragma once
+#include "../Lists.h"
+
+namespace RLGPC {
+	// Calibration of numThreads, numGamesPerThread, ppo.miniBatchSize and ppo.learnThreads for this machine
+	struct AutoTunerConfig {
+		// JSON profile of tuned values, set empty to disable auto-tuning
+		// If the profile exists, it is loaded and applied to the learner config
+		// Otherwise, calibration is run on startup and the results are saved to it
+		std::filesystem::path profilePath = {};
+
+		// Run calibration even if the profile already exists (it will be overwritten)
+		bool forceRetune = false;
+
+		// Search grid
+		// If a list is empty, that value is left as-is in the learner config
+		IList numThreadsOptions = { 4, 8, 12, 16 };
+		IList numGamesPerThreadOptions = { 8, 16, 32 };
+
+		// Only used on GPU (on CPU, the minibatch size is determined by ppo.learnThreads)
+		// Options that batchSize isn't a multiple of are skipped
+		std::vector<int64_t> miniBatchSizeOptions = {};
+
+		// Only used on CPU, 0 = the default (1.5x the hardware thread count)
+		IList learnThreadsOptions = { 0 };
+
+		// Timesteps to collect for each collection trial
+		int64_t trialTimesteps = 20 * 1000;
+
+		// Trials that push the process memory usage (RSS) above this at their peak are rejected, 0 = no cap
+		// Memory freed by earlier trials is given back to the OS before each trial where possible (glibc), so it isn't counted again
+		float maxMemoryGB = 0;
+	};
+}
@@ -0,0 +1,165 @@
+#include "BCDataset.h"
+
+using namespace RLGPC;
+
+constexpr size_t BC_WRITE_BUFFER_SIZE = 16 * 1024 * 1024;
+
+BCDatasetWriter::BCDatasetWriter(std::filesystem::path path, int obsSize, bool hasReturns) {
+	_fileStream = std::ofstream(path, std::ios::binary | std::ios::trunc);
+	if (!_fileStream.good())
+		RG_ERR_CLOSE("BCDatasetWriter(): Failed to open " << path << " for writing");
+
+	header = {};
+	memcpy(header.magic, BC_DATASET_MAGIC, sizeof(header.magic));
+	header.version = BC_DATASET_VERSION;
+	header.obsSize = obsSize;
+	header.hasReturns = hasReturns;
+	_fileStream.write((const char*)&header, sizeof(header));
+
+	_buffer.reserve(BC_WRITE_BUFFER_SIZE);
+}
+
+BCDatasetWriter::~BCDatasetWriter() {
+	Flush();
+}
+
+void BCDatasetWriter::Add(const float* obs, int actionIndex, float returnValue) {
+	int32_t actionIndex32 = actionIndex;
+
+	_buffer.insert(_buffer.end(), (const byte*)obs, (const byte*)(obs + header.obsSize));
+	_buffer.insert(_buffer.end(), (const byte*)&actionIndex32, (const byte*)(&actionIndex32 + 1));
+	if (header.hasReturns)
+		_buffer.insert(_buffer.end(), (const byte*)&returnValue, (const byte*)(&returnValue + 1));
+	numRows++;
+
+	if (_buffer.size() >= BC_WRITE_BUFFER_SIZE)
+		Flush();
+}
+
+void BCDatasetWriter::Flush() {
+	if (_buffer.empty())
+		return;
+
+	_fileStream.write((const char*)_buffer.data(), _buffer.size());
+	_fileStream.flush();
+	if (!_fileStream.good())
+		RG_ERR_CLOSE("BCDatasetWriter::Flush(): Failed to write to file");
+
+	_buffer.clear();
+}
+
+uint64_t BCDatasetWriter::WriteFromReplays(RLGSC::ReplayDataset& replayDataset, std::filesystem::path path) {
+	BCDatasetWriter writer = BCDatasetWriter(path, replayDataset.obsSize, false);
+
+	FList obs;
+	IList actions;
+	replayDataset.Restart();
+	while (true) {
+		obs.clear();
+		actions.clear();
+		if (!replayDataset.NextBatch(RS_MAX(4096, replayDataset.file->header.numCars), obs, actions))
+			break;
+
+		for (size_t i = 0; i < actions.size(); i++)
+			writer.Add(obs.data() + i * replayDataset.obsSize, actions[i]);
+	}
+
+	writer.Flush();
+	return writer.numRows;
+}
+
+BCDatasetReader::BCDatasetReader(std::filesystem::path path, int64_t blockRows, int64_t shuffleBufferRows, int seed) :
+	blockRows(RS_MAX(blockRows, 1)), shuffleBufferRows(RS_MAX(shuffleBufferRows, blockRows)), _rng(seed) {
+
+	constexpr const char* ERR_PREFIX = "BCDatasetReader(): ";
+
+	_fileStream = std::ifstream(path, std::ios::binary);
+	if (!_fileStream.good())
+		RG_ERR_CLOSE(ERR_PREFIX << "Failed to open " << path);
+
+	_fileStream.read((char*)&header, sizeof(header));
+	if (!_fileStream.good() || memcmp(header.magic, BC_DATASET_MAGIC, sizeof(header.magic)) != 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "File " << path << " is not a BC dataset");
+
+	if (header.version != BC_DATASET_VERSION)
+		RG_ERR_CLOSE(ERR_PREFIX << "File " << path << " has version " << header.version << ", expected " << BC_DATASET_VERSION);
+
+	_rowSize = header.GetRowSize();
+	numRows = (std::filesystem::file_size(path) - sizeof(header)) / _rowSize;
+	if (numRows == 0)
+		RG_ERR_CLOSE(ERR_PREFIX << "File " << path << " has no rows");
+
+	uint64_t numBlocks = (numRows + this->blockRows - 1) / this->blockRows;
+	_blockOrder.resize(numBlocks);
+	for (uint64_t i = 0; i < numBlocks; i++)
+		_blockOrder[i] = i;
+
+	StartEpoch();
+}
+
+void BCDatasetReader::StartEpoch() {
+	std::shuffle(_blockOrder.begin(), _blockOrder.end(), _rng);
+	_nextBlock = 0;
+	_buffer.clear();
+	_bufferOrder.clear();
+	_bufferPos = 0;
+}
+
+bool BCDatasetReader::_Refill() {
+	_buffer.clear();
+	_bufferOrder.clear();
+	_bufferPos = 0;
+
+	uint64_t bufferRows = 0;
+	while (_nextBlock < _blockOrder.size() && (bufferRows == 0 || bufferRows + blockRows <= shuffleBufferRows)) {
+		uint64_t firstRow = _blockOrder[_nextBlock++] * blockRows;
+		uint64_t rowsToRead = RS_MIN((uint64_t)blockRows, numRows - firstRow);
+
+		_buffer.resize((bufferRows + rowsToRead) * _rowSize);
+		_fileStream.clear();
+		_fileStream.seekg(sizeof(header) + firstRow * _rowSize);
+		_fileStream.read((char*)_buffer.data() + bufferRows * _rowSize, rowsToRead * _rowSize);
+		if (!_fileStream.good())
+			RG_ERR_CLOSE("BCDatasetReader: Failed to read rows " << firstRow << "-" << (firstRow + rowsToRead));
+
+		bufferRows += rowsToRead;
+	}
+
+	_bufferOrder.resize(bufferRows);
+	for (uint32_t i = 0; i < bufferRows; i++)
+		_bufferOrder[i] = i;
+	std::shuffle(_bufferOrder.begin(), _bufferOrder.end(), _rng);
+
+	return bufferRows > 0;
+}
+
+bool BCDatasetReader::NextBatch(int64_t batchSize, FList& obsOut, IList& actionsOut, FList& returnsOut) {
+	obsOut.clear();
+	actionsOut.clear();
+	returnsOut.clear();
+
+	while (actionsOut.size() < batchSize) {
+		if (_bufferPos >= _bufferOrder.size())
+			if (!_Refill())
+				break;
+
+		const byte* row = _buffer.data() + (size_t)_bufferOrder[_bufferPos++] * _rowSize;
+
+		const float* obs = (const float*)row;
+		obsOut.insert(obsOut.end(), obs, obs + header.obsSize);
+		row += sizeof(float) * header.obsSize;
+
+		int32_t actionIndex;
+		memcpy(&actionIndex, row, sizeof(actionIndex));
+		actionsOut.push_back(actionIndex);
+		row += sizeof(actionIndex);
+
+		if (header.hasReturns) {
+			float returnValue;
+			memcpy(&returnValue, row, sizeof(returnValue));
+			returnsOut.push_back(returnValue);
+		}
+	}
+
+	return !actionsOut.empty();
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "../Lists.h"
+#include <RLGymSim_CPP/Utils/Replays/ReplayDataset.h>
+
+#include <random>
+
+// Binary dataset of (observation, action index) samples for supervised pretraining (see Learner::Pretrain())
+//	Layout: BCDatasetHeader, then rows of obsSize floats, an int32 action index, and a float return if hasReturns
+namespace RLGPC {
+	constexpr char BC_DATASET_MAGIC[4] = { 'R', 'G', 'B', 'C' };
+	constexpr uint32_t BC_DATASET_VERSION = 1;
+
+	struct BCDatasetHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t obsSize;
+		uint32_t hasReturns;
+
+		size_t GetRowSize() const {
+			return sizeof(float) * obsSize + sizeof(int32_t) + (hasReturns ? sizeof(float) : 0);
+		}
+	};
+
+	class RG_IMEXPORT BCDatasetWriter {
+	public:
+		BCDatasetHeader header;
+		uint64_t numRows = 0;
+
+		BCDatasetWriter(std::filesystem::path path, int obsSize, bool hasReturns);
+		~BCDatasetWriter();
+
+		RG_NO_COPY(BCDatasetWriter);
+
+		// "obs" must be header.obsSize floats
+		void Add(const float* obs, int actionIndex, float returnValue = 0);
+
+		void Flush();
+
+		// Writes every sample of a replay dataset (without returns)
+		// Returns the amount of rows written
+		static uint64_t WriteFromReplays(RLGSC::ReplayDataset& replayDataset, std::filesystem::path path);
+
+	private:
+		std::ofstream _fileStream;
+		std::vector<byte> _buffer;
+	};
+
+	// Streams a dataset in shuffled order while only keeping a bounded amount of it in memory
+	// Each epoch, the file is split into blocks of contiguous rows, and blocks are read in a random order into a shuffle buffer
+	//	which is then shuffled and consumed before the next blocks are read
+	class RG_IMEXPORT BCDatasetReader {
+	public:
+		BCDatasetHeader header;
+		uint64_t numRows;
+
+		int64_t blockRows, shuffleBufferRows;
+
+		BCDatasetReader(std::filesystem::path path, int64_t blockRows = 4096, int64_t shuffleBufferRows = 1000 * 1000, int seed = 0);
+
+		RG_NO_COPY(BCDatasetReader);
+
+		// Re-shuffles the block order and restarts from the beginning
+		void StartEpoch();
+
+		// Replaces the contents of the outputs with up to batchSize rows (returnsOut is left empty if the dataset has no returns)
+		// Returns false once the epoch is over
+		bool NextBatch(int64_t batchSize, FList& obsOut, IList& actionsOut, FList& returnsOut);
+
+	private:
+		std::ifstream _fileStream;
+		std::mt19937_64 _rng;
+		size_t _rowSize;
+
+		std::vector<uint64_t> _blockOrder;
+		size_t _nextBlock = 0;
+
+		std::vector<byte> _buffer;
+		std::vector<uint32_t> _bufferOrder;
+		size_t _bufferPos = 0;
+
+		bool _Refill();
+	};
+}
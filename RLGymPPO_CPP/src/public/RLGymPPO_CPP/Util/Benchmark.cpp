@@ -0,0 +1,410 @@
+#include "Benchmark.h"
+
+#include "Timer.h"
+#include "../Learner.h"
+
+#include <RLGymPPO_CPP/PPO/PPOLearner.h>
+#include <RLGymPPO_CPP/PPO/ExperienceBuffer.h>
+#include <RLGymPPO_CPP/Threading/ThreadAgentManager.h>
+#include <RLGymPPO_CPP/Util/MemoryUsage.h>
+
+#include <torch/torch.h>
+#include "../libsrc/json/nlohmann/json.hpp"
+
+#include <random>
+
+using namespace nlohmann;
+
+namespace RLGPC {
+
+	// Makes a JSON object of the timings of a repeated measurement
+	// "amount" is how many units of work were done per run (ticks, steps, timesteps, etc.)
+	json MakeTimingJSON(const std::vector<double>& times, double amount) {
+		double bestTime = *std::min_element(times.begin(), times.end());
+		double meanTime = 0;
+		for (double time : times)
+			meanTime += time;
+		meanTime /= times.size();
+
+		json result = {};
+		result["amount"] = amount;
+		result["best_time"] = bestTime;
+		result["mean_time"] = meanTime;
+		result["best_per_sec"] = amount / RS_MAX(bestTime, 1e-9);
+		result["mean_per_sec"] = amount / RS_MAX(meanTime, 1e-9);
+		return result;
+	}
+
+	json RunArenaStepBench(const BenchmarkConfig& config) {
+		constexpr int CONTROLS_INTERVAL = 8; // Change controls at the same rate as a gym with tick skip 8
+
+		json result = json::array();
+		for (int teamSize : config.arenaTeamSizes) {
+			std::vector<double> times;
+			for (int i = 0; i < config.repeats; i++) {
+				Arena* arena = Arena::Create(GameMode::SOCCAR);
+
+				// Keep our own car list so controls are assigned in a fixed order
+				std::vector<Car*> cars;
+				for (int j = 0; j < teamSize; j++) {
+					cars.push_back(arena->AddCar(Team::BLUE));
+					cars.push_back(arena->AddCar(Team::ORANGE));
+				}
+				arena->ResetToRandomKickoff(config.randomSeed + i);
+
+				std::mt19937 rng(config.randomSeed + i);
+				std::uniform_real_distribution<float> dist(-1, 1);
+
+				Timer timer;
+				for (int tick = 0; tick < config.arenaTicks; tick += CONTROLS_INTERVAL) {
+					for (Car* car : cars) {
+						CarControls controls = {};
+						controls.throttle = dist(rng);
+						controls.steer = dist(rng);
+						controls.pitch = dist(rng);
+						controls.yaw = dist(rng);
+						controls.roll = dist(rng);
+						controls.boost = dist(rng) > 0;
+						controls.jump = dist(rng) > 0.8f;
+						controls.handbrake = dist(rng) > 0.8f;
+						car->controls = controls;
+					}
+
+					arena->Step(RS_MIN(CONTROLS_INTERVAL, config.arenaTicks - tick));
+				}
+				times.push_back(timer.Elapsed());
+
+				delete arena;
+			}
+
+			json entry = MakeTimingJSON(times, config.arenaTicks);
+			entry["team_size"] = teamSize;
+			result.push_back(entry);
+		}
+		return result;
+	}
+
+	json RunArenaCreateBench(const BenchmarkConfig& config) {
+		json result = {};
+		for (bool useFactory : { false, true }) {
+			std::vector<double> times;
+			double memoryPerArena = 0;
+			for (int i = 0; i < config.repeats; i++) {
+				ArenaFactory* factory = useFactory ? new ArenaFactory(config.arenaCreateAmount) : NULL;
+				std::vector<Arena*> arenas;
+				arenas.reserve(config.arenaCreateAmount);
+
+				uint64_t memoryBefore = GetProcessMemoryUsage();
+				Timer timer;
+				for (int j = 0; j < config.arenaCreateAmount; j++) {
+					Arena* arena = useFactory ? factory->Create(GameMode::SOCCAR) : Arena::Create(GameMode::SOCCAR);
+					arena->AddCar(Team::BLUE);
+					arena->AddCar(Team::ORANGE);
+					arenas.push_back(arena);
+				}
+				times.push_back(timer.Elapsed());
+
+				// Memory freed by previous repeats can be re-used, so this can under-estimate slightly
+				memoryPerArena += (double)((int64_t)GetProcessMemoryUsage() - (int64_t)memoryBefore) / config.arenaCreateAmount;
+
+				for (Arena* arena : arenas)
+					delete arena;
+				delete factory;
+			}
+
+			json entry = MakeTimingJSON(times, config.arenaCreateAmount);
+			entry["memory_per_arena_kb"] = memoryPerArena / config.repeats / 1024;
+			result[useFactory ? "factory" : "default"] = entry;
+		}
+		return result;
+	}
+
+	json RunGymStepBench(EnvCreateFn envCreateFn, const BenchmarkConfig& config) {
+		std::vector<double> times;
+		int playerAmount = 0;
+		for (int i = 0; i < config.repeats; i++) {
+			RocketSim::Math::GetRandEngine().seed(config.randomSeed + i);
+
+			auto envCreateResult = envCreateFn();
+			GameInst game = GameInst(envCreateResult.gym, envCreateResult.match);
+			game.Start();
+
+			playerAmount = game.match->playerAmount;
+			int actionAmount = game.match->actionParser->GetActionAmount();
+
+			std::mt19937 rng(config.randomSeed + i);
+			IList actions = IList(playerAmount);
+
+			Timer timer;
+			for (int step = 0; step < config.gymSteps; step++) {
+				for (int& action : actions)
+					action = rng() % actionAmount;
+				game.Step(actions);
+			}
+			times.push_back(timer.Elapsed());
+		}
+
+		json result = MakeTimingJSON(times, config.gymSteps);
+		result["players"] = playerAmount;
+		return result;
+	}
+
+	json RunOBSBuildBench(EnvCreateFn envCreateFn, const BenchmarkConfig& config) {
+		constexpr int WARMUP_STEPS = 100;
+
+		RocketSim::Math::GetRandEngine().seed(config.randomSeed);
+
+		auto envCreateResult = envCreateFn();
+		GameInst game = GameInst(envCreateResult.gym, envCreateResult.match);
+		game.Start();
+
+		// Get a state from the middle of a game
+		int playerAmount = game.match->playerAmount;
+		int actionAmount = game.match->actionParser->GetActionAmount();
+		std::mt19937 rng(config.randomSeed);
+		IList actions = IList(playerAmount);
+		for (int step = 0; step < WARMUP_STEPS; step++) {
+			for (int& action : actions)
+				action = rng() % actionAmount;
+			game.Step(actions);
+		}
+
+		const GameState& state = game.gym->prevState;
+		const ActionSet& prevActions = game.match->prevActions;
+		OBSBuilder* obsBuilder = game.match->obsBuilder;
+		int obsSize = game.curObs[0].size();
+		FList obsBuffer = FList((size_t)obsSize * playerAmount);
+
+		json result = {};
+		for (bool buildAll : { false, true }) {
+			std::vector<double> times;
+			for (int i = 0; i < config.repeats; i++) {
+				Timer timer;
+				for (int j = 0; j < config.obsBuilds; j++) {
+					obsBuilder->PreStep(state);
+					if (buildAll) {
+						obsBuilder->BuildAll(state, prevActions, obsBuffer.data(), obsSize);
+					} else {
+						for (int k = 0; k < playerAmount; k++) {
+							FList obs = obsBuilder->BuildOBS(state.players[k], state, prevActions[k]);
+							std::copy(obs.begin(), obs.end(), obsBuffer.begin() + (size_t)k * obsSize);
+						}
+					}
+				}
+				times.push_back(timer.Elapsed());
+			}
+
+			result[buildAll ? "build_all" : "build_obs"] = MakeTimingJSON(times, (double)config.obsBuilds * playerAmount);
+		}
+		result["players"] = playerAmount;
+		result["obs_size"] = obsSize;
+		result["has_fast_path"] = obsBuilder->GetOBSSize(state) > 0;
+		return result;
+	}
+
+	// Collects at least "amount" timesteps using a fresh set of agents, and outputs the time spent
+	// Steps collected during warmup are thrown away
+	GameTrajectory BenchCollect(
+		Learner& learner, EnvCreateFn envCreateFn,
+		int numThreads, int numGamesPerThread, int64_t amount, double& timeOut) {
+
+		auto device = learner.ppo->device;
+		ThreadAgentManager agentMgr = ThreadAgentManager(
+			learner.ppo->policy, learner.ppo->policyHalf, learner.expBuffer,
+			false, false, device.is_cpu() && torch::get_num_threads() > 1,
+			static_cast<uint64_t>(amount * 1.5f),
+			device
+		);
+
+		agentMgr.CreateAgents(envCreateFn, numThreads, numGamesPerThread);
+		agentMgr.StartAgents();
+
+		// Warm up
+		agentMgr.CollectTimesteps(RS_MAX(amount / 10, 1));
+		agentMgr.disableCollection = true;
+		agentMgr.CollectTimesteps(0);
+
+		Timer timer;
+		agentMgr.disableCollection = false;
+		GameTrajectory result = agentMgr.CollectTimesteps(amount);
+		timeOut = timer.Elapsed();
+
+		agentMgr.StopAgents();
+		return result;
+	}
+
+	json RunCollectionBench(Learner& learner, EnvCreateFn envCreateFn, const BenchmarkConfig& config) {
+		json result = json::array();
+		for (auto& size : config.collectionSizes) {
+			std::vector<double> times;
+			uint64_t collected = 0;
+			for (int i = 0; i < config.repeats; i++) {
+				double time;
+				GameTrajectory traj = BenchCollect(learner, envCreateFn, size.first, size.second, config.collectionTimesteps, time);
+				times.push_back(time);
+				collected += traj.size;
+			}
+
+			// Collection overshoots the requested amount, so use the average actual amount
+			json entry = MakeTimingJSON(times, collected / (double)config.repeats);
+			entry["num_threads"] = size.first;
+			entry["num_games_per_thread"] = size.second;
+			result.push_back(entry);
+		}
+		return result;
+	}
+
+	json RunAddExperienceBench(Learner& learner, const GameTrajectory& traj, const BenchmarkConfig& config) {
+		std::vector<double> times;
+		for (int i = 0; i < config.repeats; i++) {
+			// AddNewExperience() moves the tensors out, so give it a shallow copy
+			GameTrajectory trajCopy = traj;
+			Report report = {};
+
+			Timer timer;
+			learner.AddNewExperience(trajCopy, report);
+			times.push_back(timer.Elapsed());
+		}
+
+		return MakeTimingJSON(times, traj.size);
+	}
+
+	json RunPPOLearnBench(Learner& learner, const BenchmarkConfig& config) {
+		constexpr const char* ERROR_PREFIX = "RunPPOLearnBench(): ";
+
+		PPOLearner* ppo = learner.ppo;
+		PPOLearnerConfig configBackup = ppo->config;
+
+		json result = json::array();
+		for (auto& size : config.learnSizes) {
+			int64_t batchSize = size.first;
+			int64_t miniBatchSize = size.second > 0 ? size.second : batchSize;
+			if (batchSize % miniBatchSize != 0)
+				RG_ERR_CLOSE(ERROR_PREFIX << "Batch size " << batchSize << " is not a multiple of minibatch size " << miniBatchSize);
+
+			ppo->config.batchSize = batchSize;
+			ppo->config.miniBatchSize = miniBatchSize;
+
+			std::vector<double> times;
+			for (int i = 0; i < config.repeats; i++) {
+				Report report = {};
+
+				Timer timer;
+				ppo->Learn(learner.expBuffer, report);
+				times.push_back(timer.Elapsed());
+			}
+
+			int64_t samplesPerEpoch = (learner.expBuffer->curSize / batchSize) * batchSize;
+			json entry = MakeTimingJSON(times, (double)samplesPerEpoch * ppo->config.epochs);
+			entry["batch_size"] = batchSize;
+			entry["minibatch_size"] = miniBatchSize;
+			entry["epochs"] = ppo->config.epochs;
+			result.push_back(entry);
+		}
+
+		ppo->config = configBackup;
+		return result;
+	}
+
+	std::string RunBenchmark(EnvCreateFn envCreateFn, BenchmarkConfig config) {
+		constexpr const char* ERROR_PREFIX = "RunBenchmark(): ";
+		constexpr const char* SCENARIO_NAMES[] = {
+			"arena_step", "arena_create", "gym_step", "obs_build", "collection", "add_experience", "ppo_learn"
+		};
+
+		if (config.repeats < 1)
+			RG_ERR_CLOSE(ERROR_PREFIX << "config.repeats must be at least 1");
+
+		for (auto& scenario : config.scenarios)
+			if (std::find(std::begin(SCENARIO_NAMES), std::end(SCENARIO_NAMES), scenario) == std::end(SCENARIO_NAMES))
+				RG_ERR_CLOSE(ERROR_PREFIX << "Unknown scenario \"" << scenario << "\"");
+
+		auto fnShouldRun = [&](const std::string& scenario) {
+			return config.scenarios.empty() || std::find(config.scenarios.begin(), config.scenarios.end(), scenario) != config.scenarios.end();
+		};
+
+		if (RocketSim::GetStage() != RocketSimStage::INITIALIZED)
+			RocketSim::Init("collision_meshes", true);
+
+		json j = {};
+		{
+			auto& jConfig = j["config"];
+			jConfig["random_seed"] = config.randomSeed;
+			jConfig["repeats"] = config.repeats;
+			jConfig["hardware_concurrency"] = std::thread::hardware_concurrency();
+			jConfig["policy_layer_sizes"] = config.learnerConfig.ppo.policyLayerSizes;
+			jConfig["critic_layer_sizes"] = config.learnerConfig.ppo.criticLayerSizes;
+		}
+
+		auto& results = j["results"];
+
+		if (fnShouldRun("arena_step")) {
+			RG_LOG("Running arena_step benchmark...");
+			results["arena_step"] = RunArenaStepBench(config);
+		}
+
+		if (fnShouldRun("arena_create")) {
+			RG_LOG("Running arena_create benchmark...");
+			results["arena_create"] = RunArenaCreateBench(config);
+		}
+
+		if (fnShouldRun("gym_step")) {
+			RG_LOG("Running gym_step benchmark...");
+			results["gym_step"] = RunGymStepBench(envCreateFn, config);
+		}
+
+		if (fnShouldRun("obs_build")) {
+			RG_LOG("Running obs_build benchmark...");
+			results["obs_build"] = RunOBSBuildBench(envCreateFn, config);
+		}
+
+		bool needsLearner = fnShouldRun("collection") || fnShouldRun("add_experience") || fnShouldRun("ppo_learn");
+		if (needsLearner) {
+			LearnerConfig learnerConfig = config.learnerConfig;
+			learnerConfig.randomSeed = config.randomSeed;
+			learnerConfig.sendMetrics = false;
+			learnerConfig.renderMode = false;
+			learnerConfig.checkpointSaveFolder.clear();
+			learnerConfig.skillTrackerConfig.enabled = false;
+
+			// We make our own agents for each scenario
+			learnerConfig.numThreads = learnerConfig.numGamesPerThread = 1;
+
+			int64_t maxBatchSize = 0;
+			for (auto& size : config.learnSizes)
+				maxBatchSize = RS_MAX(maxBatchSize, size.first);
+			learnerConfig.expBufferSize = RS_MAX(learnerConfig.expBufferSize, maxBatchSize);
+
+			Learner learner = Learner(envCreateFn, learnerConfig);
+			j["config"]["device"] = learner.ppo->device.str();
+
+			if (fnShouldRun("collection")) {
+				RG_LOG("Running collection benchmark...");
+				results["collection"] = RunCollectionBench(learner, envCreateFn, config);
+			}
+
+			if (fnShouldRun("add_experience") || fnShouldRun("ppo_learn")) {
+				RG_LOG("Collecting timesteps for add_experience/ppo_learn...");
+				double collectTime;
+				auto collectSize = config.collectionSizes.empty() ? std::pair<int, int>(1, 16) : config.collectionSizes.back();
+				GameTrajectory traj = BenchCollect(
+					learner, envCreateFn, collectSize.first, collectSize.second,
+					RS_MAX(config.collectionTimesteps, maxBatchSize), collectTime
+				);
+
+				// Always fills the experience buffer, even if the scenario isn't reported
+				RG_LOG("Running add_experience benchmark...");
+				json addExpResult = RunAddExperienceBench(learner, traj, config);
+				if (fnShouldRun("add_experience"))
+					results["add_experience"] = addExpResult;
+
+				if (fnShouldRun("ppo_learn")) {
+					RG_LOG("Running ppo_learn benchmark...");
+					results["ppo_learn"] = RunPPOLearnBench(learner, config);
+				}
+			}
+		}
+
+		return j.dump(4);
+	}
+}
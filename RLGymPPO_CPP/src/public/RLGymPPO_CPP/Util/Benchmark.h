@@ -0,0 +1,47 @@
+#pragma once
+#include "../LearnerConfig.h"
+
+namespace RLGPC {
+	struct BenchmarkConfig {
+		// Scenarios to run, leave empty to run all of them
+		// Valid scenarios: "arena_step", "arena_create", "gym_step", "obs_build", "collection", "add_experience", "ppo_learn"
+		std::vector<std::string> scenarios = {};
+
+		// Seeds RocketSim, torch, and the experience buffer
+		int randomSeed = 123;
+
+		// Number of times each measurement is repeated, the best run is reported along with the mean
+		int repeats = 3;
+
+		// Raw Arena::Step() ticks/second, measured for each team size
+		IList arenaTeamSizes = { 1, 2, 3 };
+		int arenaTicks = 120 * 60;
+
+		// Time and memory to create this many 1v1 arenas, both with Arena::Create() and with a shared RocketSim::ArenaFactory
+		int arenaCreateAmount = 300;
+
+		// Gym::Step() steps/second on a single game from the env create func
+		int gymSteps = 10 * 1000;
+
+		// Observations/second of the env create func's OBS builder, building all players of one game each time
+		// Measured both with BuildOBS() for each player and with BuildAll()
+		int obsBuilds = 100 * 1000;
+
+		// Full ThreadAgent collection, measured for each { numThreads, numGamesPerThread } pair
+		std::vector<std::pair<int, int>> collectionSizes = { { 1, 16 }, { 4, 16 }, { 8, 16 } };
+		int64_t collectionTimesteps = 50 * 1000;
+
+		// PPOLearner::Learn(), measured for each { batchSize, miniBatchSize } pair
+		// The largest batch size determines how many timesteps are collected up front
+		std::vector<std::pair<int64_t, int64_t>> learnSizes = { { 50 * 1000, 50 * 1000 }, { 50 * 1000, 12500 } };
+
+		// Model sizes, epochs, device, etc. come from here
+		// Loading a policy from learnerConfig.checkpointLoadFolder is supported, otherwise the models are randomly initialized
+		// Metrics, saving, rendering and the skill tracker are always disabled
+		LearnerConfig learnerConfig = {};
+	};
+
+	// Runs the throughput benchmarks from BenchmarkConfig and returns the results as a JSON string
+	// NOTE: Collection threads seed their own RocketSim RNG, so only single-threaded scenarios are fully reproducible
+	RG_IMEXPORT std::string RunBenchmark(EnvCreateFn envCreateFn, BenchmarkConfig config);
+}
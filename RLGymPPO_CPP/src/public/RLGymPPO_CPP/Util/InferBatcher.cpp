@@ -0,0 +1,115 @@
+#include "InferBatcher.h"
+
+using namespace RLGSC;
+using namespace RLGPC;
+
+RLGPC::InferBatcher::InferBatcher(InferUnit* inferUnit, double batchWindow, bool deterministic, float temperature)
+	: inferUnit(inferUnit), deterministic(deterministic), temperature(temperature), batchWindow(batchWindow) {
+	RG_ASSERT(inferUnit);
+	RG_ASSERT(batchWindow >= 0);
+}
+
+void RLGPC::InferBatcher::AddClient() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_numClients++;
+}
+
+void RLGPC::InferBatcher::RemoveClient() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_numClients--;
+
+	// The batch being collected may be full now
+	_condVar.notify_all();
+}
+
+Action RLGPC::InferBatcher::InferPolicy(const PlayerData& player, const GameState& state, const Action& prevAction) {
+	_Request request = {};
+	request.playerRequest = { &player, &state, &prevAction };
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_pending.push_back(&request);
+
+	auto fnIsFull = [this]() {
+		return (int)_pending.size() >= RS_MAX(_numClients, 1);
+	};
+
+	if (_pending.size() == 1) {
+		// We are the first request, so we run this batch
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(batchWindow);
+		_condVar.wait_until(lock, deadline, fnIsFull);
+
+		std::vector<_Request*> batch = {};
+		batch.swap(_pending);
+		lock.unlock();
+
+		_RunBatch(batch);
+
+		lock.lock();
+		for (_Request* batchRequest : batch)
+			batchRequest->done = true;
+		_condVar.notify_all();
+	} else {
+		if (fnIsFull())
+			_condVar.notify_all();
+
+		_condVar.wait(lock, [&request]() { return request.done; });
+	}
+
+	return request.result;
+}
+
+void RLGPC::InferBatcher::_RunBatch(std::vector<_Request*>& batch) {
+	std::vector<InferUnit::PlayerRequest> playerRequests;
+	playerRequests.reserve(batch.size());
+	for (_Request* request : batch)
+		playerRequests.push_back(request->playerRequest);
+
+	std::vector<Action> results;
+	{
+		std::lock_guard<std::mutex> inferLock(_inferMutex);
+		results = inferUnit->InferPolicyBatch(playerRequests, deterministic, temperature);
+
+		for (int i = 0; i < batch.size(); i++) {
+			batch[i]->result = results[i];
+			_latencies.push_back(batch[i]->timer.Elapsed());
+		}
+
+		_batchesSinceReport++;
+		if (_batchesSinceReport < RS_MAX(latencyReportInterval, 1))
+			return;
+
+		LatencyStats stats = {};
+		std::sort(_latencies.begin(), _latencies.end());
+		auto fnPercentile = [&](double fraction) {
+			size_t index = RS_MIN((size_t)(fraction * _latencies.size()), _latencies.size() - 1);
+			return _latencies[index];
+		};
+		stats.p50 = fnPercentile(0.5);
+		stats.p90 = fnPercentile(0.9);
+		stats.p99 = fnPercentile(0.99);
+		stats.max = _latencies.back();
+		stats.numRequests = _latencies.size();
+		stats.avgBatchSize = _latencies.size() / (float)_batchesSinceReport;
+
+		_latencies.clear();
+		_batchesSinceReport = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_lastLatencyStats = stats;
+		}
+
+		if (logLatency) {
+			RG_LOG(
+				"InferBatcher: Latency (ms) p50: " << (stats.p50 * 1000) << ", p90: " << (stats.p90 * 1000) <<
+				", p99: " << (stats.p99 * 1000) << ", max: " << (stats.max * 1000) <<
+				" (avg batch size: " << stats.avgBatchSize << ")"
+			);
+		}
+	}
+}
+
+RLGPC::InferBatcher::LatencyStats RLGPC::InferBatcher::GetLatencyStats() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _lastLatencyStats;
+}
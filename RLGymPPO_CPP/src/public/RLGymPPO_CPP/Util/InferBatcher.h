@@ -0,0 +1,67 @@
+#pragma once
+#include "InferUnit.h"
+#include "Timer.h"
+
+#include <mutex>
+#include <condition_variable>
+
+namespace RLGPC {
+	// Collects policy inference requests from many threads (e.g. one per RLBot bot), and infers them together with one forward
+	// The first request of a batch waits until every expected client has sent a request, or until the batch window has passed
+	class RG_IMEXPORT InferBatcher {
+	public:
+		InferUnit* inferUnit; // Not owned
+
+		bool deterministic;
+		float temperature;
+
+		// Max time (in seconds) the first request of a batch waits for the other clients
+		double batchWindow;
+
+		// Latency percentiles are computed (and logged, if enabled) every this many batches
+		int latencyReportInterval = 120;
+		bool logLatency = false;
+
+		// Request latencies, from the request being made to its action being returned (in seconds)
+		struct LatencyStats {
+			double p50 = 0, p90 = 0, p99 = 0, max = 0;
+			int numRequests = 0;
+			float avgBatchSize = 0;
+		};
+
+		InferBatcher(InferUnit* inferUnit, double batchWindow = 0.002, bool deterministic = true, float temperature = 1.0f);
+
+		RG_NO_COPY(InferBatcher);
+
+		// Each client that will be making requests should be added, so full batches don't wait for the window
+		void AddClient();
+		void RemoveClient();
+
+		// Blocks until the batch with this request has been inferred
+		RLGSC::Action InferPolicy(const RLGSC::PlayerData& player, const RLGSC::GameState& state, const RLGSC::Action& prevAction);
+
+		// Stats from the last latencyReportInterval batches
+		LatencyStats GetLatencyStats();
+
+		struct _Request {
+			InferUnit::PlayerRequest playerRequest;
+			RLGSC::Action result = {};
+			bool done = false;
+			Timer timer;
+		};
+
+		std::mutex _mutex = {};
+		std::condition_variable _condVar = {};
+		int _numClients = 0;
+		std::vector<_Request*> _pending;
+
+		// Only one batch is inferred at a time, while the next one can be collected
+		std::mutex _inferMutex = {};
+
+		std::vector<double> _latencies;
+		int _batchesSinceReport = 0;
+		LatencyStats _lastLatencyStats = {};
+
+		void _RunBatch(std::vector<_Request*>& batch);
+	};
+}
@@ -11,6 +11,12 @@ namespace RLGPC {
         RLGSC::ActionParser* actionParser;
         class DiscretePolicy* policy;
         class ValueEstimator* critic;
+        struct OBSStandardizer* obsStandardizer;
+        // Keeps obsStandardizer's stats on the model's device, so they aren't copied over for every inference
+        struct OBSStandardizerReader* obsStandardizerReader;
+
+        // Re-used by InferPolicySingle() if the OBS builder supports writing directly to memory
+        RLGSC::FList _singleOBS;
 
         InferUnit(
             RLGSC::OBSBuilder* obsBuilder, RLGSC::ActionParser* actionParser,
@@ -18,6 +24,10 @@ namespace RLGPC {
 
         ~InferUnit();
 
+        // Loads the observation stats from a checkpoint's RUNNING_STATS.json, and standardizes all observations with them
+        // Required if the model was trained with LearnerConfig::standardizeOBS, clipRange should match LearnerConfig::obsClipRange
+        void LoadOBSStats(std::filesystem::path runningStatsPath, float clipRange = 5);
+
         RLGSC::FList GetObs(const RLGSC::PlayerData& player, const RLGSC::GameState& state, const RLGSC::Action& prevAction);
         RLGSC::FList2 GetObs(const RLGSC::GameState& state, const RLGSC::ActionSet& prevActions);
 
@@ -29,6 +39,20 @@ namespace RLGPC {
             const RLGSC::PlayerData& player, const RLGSC::GameState& state, const RLGSC::Action& prevAction,
             bool deterministic, float temperature = 1.0f
         );
+
+        // One player of a state to infer the policy for, see InferPolicyBatch()
+        struct PlayerRequest {
+            const RLGSC::PlayerData* player;
+            const RLGSC::GameState* state;
+            const RLGSC::Action* prevAction;
+        };
+
+        // Infers the actions of players from any number of states with a single forward
+        std::vector<RLGSC::Action> InferPolicyBatch(
+            const std::vector<PlayerRequest>& requests,
+            bool deterministic, float temperature = 1.0f
+        );
+
         RLGSC::FList InferPolicySingleDistrib(
             const RLGSC::PlayerData& player, const RLGSC::GameState& state, const RLGSC::Action& prevAction,
             float temperature = 1.0f
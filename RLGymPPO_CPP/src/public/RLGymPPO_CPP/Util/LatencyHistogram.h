@@ -0,0 +1,41 @@
+#pragma once
+#include "../Framework.h"
+
+namespace RLGPC {
+	// Fixed-size latency histogram, adding samples never allocates
+	struct LatencyHistogram {
+		static constexpr double BUCKET_SIZE = 10e-6; // 10 microseconds
+		static constexpr int NUM_BUCKETS = 2000; // Up to 20ms, slower samples go in the last bucket
+
+		std::array<uint32_t, NUM_BUCKETS> buckets = {};
+		uint32_t count = 0;
+		double max = 0; // In seconds
+
+		void Add(double seconds) {
+			int bucket = RS_CLAMP((int)(seconds / BUCKET_SIZE), 0, NUM_BUCKETS - 1);
+			buckets[bucket]++;
+			count++;
+			max = RS_MAX(max, seconds);
+		}
+
+		// Returns the upper bound of the bucket the percentile falls in (in seconds)
+		double GetPercentile(double fraction) const {
+			if (count == 0)
+				return 0;
+
+			uint64_t target = (uint64_t)(fraction * count);
+			uint64_t total = 0;
+			for (int i = 0; i < NUM_BUCKETS; i++) {
+				total += buckets[i];
+				if (total > target)
+					return RS_MIN((i + 1) * BUCKET_SIZE, max);
+			}
+
+			return max;
+		}
+
+		void Reset() {
+			*this = {};
+		}
+	};
+}
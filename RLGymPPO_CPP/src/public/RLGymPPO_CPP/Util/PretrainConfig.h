@@ -0,0 +1,28 @@
+#pragma once
+#include "../Lists.h"
+
+namespace RLGPC {
+	// Supervised pretraining (behaviour cloning) of the policy, see Learner::Pretrain()
+	struct PretrainConfig {
+		// BC dataset file (see BCDataset.h)
+		std::filesystem::path datasetPath = {};
+
+		int epochs = 5;
+		int64_t batchSize = 10 * 1000;
+
+		float policyLR = 3e-4f;
+
+		// The critic is only trained if the dataset has returns, set to 0 to never train it
+		float criticLR = 3e-4f;
+
+		// Rows read into memory and shuffled together, this bounds the memory used by the dataset
+		int64_t shuffleBufferRows = 1000 * 1000;
+
+		// Rows in each contiguous block read from the dataset, blocks are read in a random order
+		int64_t blockRows = 4096;
+
+		// Save a checkpoint after every epoch, instead of only at the end (if checkpointSaveFolder is set)
+		// The last epoch is saved as a normal checkpoint, earlier ones go to "pretrain_epoch_<epoch>" subfolders that aren't loaded or deleted automatically
+		bool saveEveryEpoch = true;
+	};
+}
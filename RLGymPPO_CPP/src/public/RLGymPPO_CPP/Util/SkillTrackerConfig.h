@@ -21,15 +21,24 @@ namespace RLGPC {
 		int64_t timestepsPerVersion = 50 * 1000 * 1000; // Amout of timesteps between saving versions
 		int maxVersions = 4; // Maximum amount of versions to store
 
-		// Number of threads to run in parallel (more is only better to an extent)
+		// Number of threads to step the eval games with (more is only better to an extent)
+		// All games are stepped together, and the observations for each policy version are inferred in one batch
 		int numThreads = 8; 
 
+		// If true, evaluation runs as a background service on its own thread (plus numThreads stepping threads), instead of blocking the learner
+		// Every updateInterval iterations, a snapshot of the current policy is published to the service, which evaluates it in rounds of simTime
+		// Rating updates from the service show up in the next iteration's metrics
+		bool runInBackground = false;
+
+		// If true, the background service keeps evaluating the last snapshot until a new one is published, instead of waiting
+		bool continuousEval = false;
+
 		// If true, skill ratings are tracked independently per-mode
 		// A mode is determined by team sizes, and any mode is supported (1v1, 3v3, 4v4, 2v5, 1v0)
 		bool perModeRatings = true;
 
 		// If true, the skill tracker will attempt to load old versions using old checkpoints
-		// The old version must have a saved skill rating
+		// The old version must have a saved skill rating, and its policy is only loaded once a matchup needs it
 		bool loadOldVersionsFromCheckpoints = true;
 
 		// When initialized, add the current version as the first previous version
@@ -1,5 +1,5 @@
 #pragma once
-#include "../Framework.h"
+#include "../Lists.h"
 
 namespace RLGPC {
 	struct WelfordRunningStat {
@@ -13,7 +13,7 @@ namespace RLGPC {
 			this->ones = FList(shape);
 			this->zeros = FList(shape);
 			std::fill(ones.begin(), ones.end(), 1);
-			std::fill(zeros.begin(), zeros.end(), 1);
+			std::fill(zeros.begin(), zeros.end(), 0);
 
 			this->runningMean = std::vector<double>(shape);
 			this->runningVariance = std::vector<double>(shape);
@@ -23,33 +23,74 @@ namespace RLGPC {
 		}
 
 		void Increment(const FList2& samples, int num) {
-			for (int i = 0; i < num; i++)
-				Update(samples[i]);
+			IncrementBatch(num, [&](int64_t i) { return samples[i].data(); });
 		}
 
-		// TODO: Inefficient construction of another DList
 		void Increment(const FList& samples, int num) {
-			for (int i = 0; i < num; i++)
-				Update(FList({ samples[i] }));
+			RG_ASSERT(shape == 1);
+			IncrementBatch(samples.data(), num);
 		}
 
-		void Update(const FList& sample) {
-			int64_t currentCount = count;
-			count++;
+		// Adds a batch of samples stored contiguously (numSamples rows of size shape)
+		void IncrementBatch(const float* samples, int64_t numSamples) {
+			IncrementBatch(numSamples, [&](int64_t i) { return samples + i * shape; });
+		}
 
-			// TODO: Inefficient, only need 1 loop
+		// Computes the mean and variance of the whole batch first, then merges it in with Chan's parallel algorithm
+		// https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+		template <typename GetRowFn>
+		void IncrementBatch(int64_t numSamples, GetRowFn getRow) {
+			if (numSamples <= 0)
+				return;
 
-			auto delta = std::vector<double>(shape);
-			auto deltaN = std::vector<double>(shape);
-			for (int i = 0; i < shape; i++) {
-				delta[i] = sample[i] - runningMean[i];
-				deltaN[i] = delta[i] / count;
+			std::vector<double> batchMean = std::vector<double>(shape);
+			std::vector<double> batchVariance = std::vector<double>(shape);
+
+			for (int64_t i = 0; i < numSamples; i++) {
+				const float* row = getRow(i);
+				for (int j = 0; j < shape; j++)
+					batchMean[j] += row[j];
 			}
 
+			for (int j = 0; j < shape; j++)
+				batchMean[j] /= numSamples;
+
+			for (int64_t i = 0; i < numSamples; i++) {
+				const float* row = getRow(i);
+				for (int j = 0; j < shape; j++) {
+					double delta = row[j] - batchMean[j];
+					batchVariance[j] += delta * delta;
+				}
+			}
+
+			_Merge(batchMean, batchVariance, numSamples);
+		}
+
+		// Merges the samples of another stat into this one
+		void Merge(const WelfordRunningStat& other) {
+			RG_ASSERT(other.shape == shape);
+			_Merge(other.runningMean, other.runningVariance, other.count);
+		}
+
+		void _Merge(const std::vector<double>& otherMean, const std::vector<double>& otherVariance, int64_t otherCount) {
+			if (otherCount <= 0)
+				return;
+
+			int64_t totalCount = count + otherCount;
+			double otherRatio = otherCount / (double)totalCount;
+			double crossScale = count * otherRatio;
+
 			for (int i = 0; i < shape; i++) {
-				runningMean[i] += deltaN[i];
-				runningVariance[i] += delta[i] * deltaN[i] * currentCount;
+				double delta = otherMean[i] - runningMean[i];
+				runningMean[i] += delta * otherRatio;
+				runningVariance[i] += otherVariance[i] + delta * delta * crossScale;
 			}
+
+			count = totalCount;
+		}
+
+		void Update(const FList& sample) {
+			IncrementBatch(sample.data(), 1);
 		}
 
 		void Reset() {
@@ -82,4 +123,4 @@ namespace RLGPC {
 			return var;
 		}
 	};
-}
\ No newline at end of file
+}
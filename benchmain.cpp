@@ -0,0 +1,116 @@
+#include <RLGymPPO_CPP/Util/Benchmark.h>
+#include <RLGymPPO_CPP/Util/AutoTuner.h>
+
+#include <RLGymSim_CPP/Utils/RewardFunctions/CommonRewards.h>
+#include <RLGymSim_CPP/Utils/RewardFunctions/CombinedReward.h>
+#include <RLGymSim_CPP/Utils/TerminalConditions/NoTouchCondition.h>
+#include <RLGymSim_CPP/Utils/TerminalConditions/GoalScoreCondition.h>
+#include <RLGymSim_CPP/Utils/OBSBuilders/DefaultOBS.h>
+#include <RLGymSim_CPP/Utils/StateSetters/RandomState.h>
+#include <RLGymSim_CPP/Utils/ActionParsers/DiscreteAction.h>
+
+#include <fstream>
+
+using namespace RLGPC; // RLGymPPO
+using namespace RLGSC; // RLGymSim
+
+// Usage: RLGymPPO_CPP_Bench [--out <file>] [--scenario <name>]... [--seed <seed>] [--repeats <amount>] [--load <checkpoint folder>]
+// Results are written as JSON, so they can be compared between commits
+//
+// Usage: RLGymPPO_CPP_Bench --tune <profile file>
+// Runs auto-tuning only, the profile can then be used with LearnerConfig::autoTunerConfig.profilePath
+
+// Same environment as the example, so the numbers are representative of a normal training run
+EnvCreateResult EnvCreateFunc() {
+	constexpr int TICK_SKIP = 8;
+	constexpr float NO_TOUCH_TIMEOUT_SECS = 10.f;
+
+	auto rewards = new CombinedReward(
+		{
+			{ new FaceBallReward(), 0.1f },
+			{ new SpeedTowardBallReward(), 0.5f },
+			{ new VelocityBallToGoalReward(), 1.0f },
+			{ new EventReward({.teamGoal = 1.f, .concede = -1.f}), 50.f },
+		}
+	);
+
+	std::vector<TerminalCondition*> terminalConditions = {
+		new NoTouchCondition(NO_TOUCH_TIMEOUT_SECS * 120 / TICK_SKIP),
+		new GoalScoreCondition()
+	};
+
+	auto obs = new DefaultOBS();
+	auto actionParser = new DiscreteAction();
+	auto stateSetter = new RandomState(true, true, true);
+
+	Match* match = new Match(
+		rewards,
+		terminalConditions,
+		obs,
+		actionParser,
+		stateSetter,
+
+		1, // Team size
+		true // Spawn opponents
+	);
+
+	// Nothing here reads the inverted GameState fields directly, so they can all be computed on demand
+	match->gameStateFields = GSF_NONE;
+
+	Gym* gym = new Gym(match, TICK_SKIP);
+	return { match, gym };
+}
+
+int main(int argc, char* argv[]) {
+	RocketSim::Init("./collision_meshes");
+
+	BenchmarkConfig cfg = {};
+	std::string outPath = "benchmark_results.json";
+	std::string tuneProfilePath;
+
+	// Never load from the default checkpoint folder unless asked to, so runs start from the same random policy
+	cfg.learnerConfig.checkpointLoadFolder.clear();
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--out" && hasValue) {
+			outPath = argv[++i];
+		} else if (arg == "--scenario" && hasValue) {
+			cfg.scenarios.push_back(argv[++i]);
+		} else if (arg == "--seed" && hasValue) {
+			cfg.randomSeed = std::stoi(argv[++i]);
+		} else if (arg == "--repeats" && hasValue) {
+			cfg.repeats = std::stoi(argv[++i]);
+		} else if (arg == "--tune" && hasValue) {
+			tuneProfilePath = argv[++i];
+		} else if (arg == "--load" && hasValue) {
+			cfg.learnerConfig.checkpointLoadFolder = argv[++i];
+		} else {
+			RG_LOG("Unknown or incomplete argument: " << arg);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!tuneProfilePath.empty()) {
+		AutoTuneProfile profile = RunAutoTune(EnvCreateFunc, cfg.learnerConfig);
+		profile.Save(tuneProfilePath);
+		RG_LOG("Profile written to " << tuneProfilePath);
+		return 0;
+	}
+
+	std::string results = RunBenchmark(EnvCreateFunc, cfg);
+
+	std::ofstream fOut(outPath, std::ios::out | std::ios::trunc);
+	if (!fOut.good()) {
+		RG_LOG("Failed to open " << outPath << " for writing");
+		return EXIT_FAILURE;
+	}
+	fOut << results;
+
+	RG_LOG(results);
+	RG_LOG("Results written to " << outPath);
+
+	return 0;
+}
@@ -6,6 +6,7 @@
 #include <RLGymSim_CPP/Utils/TerminalConditions/GoalScoreCondition.h>
 #include <RLGymSim_CPP/Utils/OBSBuilders/DefaultOBS.h>
 #include <RLGymSim_CPP/Utils/StateSetters/RandomState.h>
+#include <RLGymSim_CPP/Utils/StateSetters/PoolState.h>
 #include <RLGymSim_CPP/Utils/ActionParsers/DiscreteAction.h>
 
 #include "RLBotClient.h"
@@ -76,6 +77,9 @@ EnvCreateResult EnvCreateFunc() {
 		}
 	);
 
+	// Uncomment to get the time and contribution of each reward in the iteration report
+	//rewards->EnableProfiling({ "Face Ball", "Speed Toward Ball", "Velocity Ball To Goal", "Goal" });
+
 	std::vector<TerminalCondition*> terminalConditions = {
 		new NoTouchCondition(NO_TOUCH_TIMEOUT_SECS * 120 / TICK_SKIP),
 		new GoalScoreCondition()
@@ -85,6 +89,10 @@ EnvCreateResult EnvCreateFunc() {
 	auto actionParser = new DiscreteAction();
 	auto stateSetter = new RandomState(true, true, true);
 
+	// Alternatively, reset to pre-simulated states (generated once and shared by all envs, or loaded with StatePool::Load())
+	//static auto statePool = std::make_shared<StatePool>(StatePool::Generate(1, 1));
+	//auto stateSetter = new PoolState(statePool);
+
 	Match* match = new Match(
 		rewards,
 		terminalConditions,
@@ -96,6 +104,9 @@ EnvCreateResult EnvCreateFunc() {
 		true // Spawn opponents
 	);
 
+	// Nothing here reads the inverted GameState fields directly, so they can all be computed on demand
+	match->gameStateFields = GSF_NONE;
+
 	Gym* gym = new Gym(match, TICK_SKIP);
 	return { match, gym };
 }
@@ -111,6 +122,9 @@ int main(int argc, char* argv[]) {
 	cfg.numThreads = 10;
 	cfg.numGamesPerThread = 15;
 
+	// Alternatively, let the learner find good values on the first run and save them to a profile
+	// cfg.autoTunerConfig.profilePath = "tune_profile.json";
+
 	// We want a large itr/batch size
 	// You'll want to increase this as your bot improves, up to an extent
 	int tsPerItr = 100 * 1000;
@@ -138,11 +152,17 @@ int main(int argc, char* argv[]) {
 	cfg.sendMetrics = true; // Send metrics
 	cfg.renderMode = false; // Don't render
 
+	// Optionally, also collect in other processes: run copies of this program with "--worker <index>" (from 0 to numCollectionWorkers-1)
+	//cfg.numCollectionWorkers = 4;
+
 	for (int i = 1; i < argc; ++i) {
 		if (std::strcmp(argv[i], "--render") == 0) {
 			cfg.renderMode = true;
 			break;
 		}
+
+		if (std::strcmp(argv[i], "--worker") == 0 && i + 1 < argc)
+			cfg.collectionWorkerIndex = std::atoi(argv[++i]);
 	}
 
 	// Make the learner with the environment creation function and the config we just made
@@ -152,6 +172,10 @@ int main(int argc, char* argv[]) {
 	learner.stepCallback = OnStep;
 	learner.iterationCallback = OnIteration;
 
+	// Optionally, pretrain the policy to imitate recorded games first
+	// The dataset can be made from a replay file with BCDatasetWriter::WriteFromReplays()
+	//learner.Pretrain({ .datasetPath = "bc_dataset.rgbc" });
+
 	// Start learning!
 	learner.Learn();
 
@@ -0,0 +1,167 @@
+#include <RLGymSim_CPP/Utils/Replays/ReplayFile.h>
+
+#include <thread>
+#include <atomic>
+#include <sstream>
+
+using namespace RLGSC; // RLGymSim
+
+// Converts recorded games from CSV to the binary replay format (see ReplayFile.h), for ReplayState and ReplayDataset
+//
+// Usage: RLGymPPO_CPP_ReplayConv --out <file> --cars <amount> [--tick-skip <ticks>] [--threads <amount>] <input csv>...
+//
+// Input files are converted in parallel, then appended to the output in the order they were given
+// Each line of an input file is one frame, empty lines and lines starting with '#' are skipped:
+//	sequence_start (1 on the first frame of a replay/segment),
+//	ball_pos_x, ball_pos_y, ball_pos_z, ball_vel_x, ball_vel_y, ball_vel_z, ball_ang_vel_x, ball_ang_vel_y, ball_ang_vel_z,
+//	34 boost pad values (1 if active, in CommonValues::BOOST_LOCATIONS order),
+//	then for each car:
+//		team (0 is blue), pos_x, pos_y, pos_z, yaw, pitch, roll, vel_x, vel_y, vel_z, ang_vel_x, ang_vel_y, ang_vel_z,
+//		boost (0-100), on_ground, has_jumped, has_double_jumped, has_flipped, has_jump, has_flip, is_demoed, ball_touched,
+//		throttle, steer, pitch, yaw, roll, jump, boost, handbrake
+// The first frame of each input file always starts a sequence
+
+constexpr int CSV_FRAME_VALUES = 1 + 9 + CommonValues::BOOST_LOCATIONS_AMOUNT;
+constexpr int CSV_CAR_VALUES = 13 + 9 + Action::ELEM_AMOUNT;
+
+void ConvertFile(std::filesystem::path inPath, std::filesystem::path outPath, int numCars, int tickSkip) {
+	std::ifstream inStream = std::ifstream(inPath);
+	if (!inStream.good())
+		RG_ERR_CLOSE("Failed to open " << inPath);
+
+	ReplayWriter writer = ReplayWriter(outPath, numCars, tickSkip);
+
+	std::vector<byte> frameBytes = std::vector<byte>(GetReplayFrameSize(numCars));
+	ReplayFrameHeader& frame = *(ReplayFrameHeader*)frameBytes.data();
+	ReplayCar* cars = (ReplayCar*)(&frame + 1);
+
+	std::vector<float> values;
+	std::string line;
+	for (int lineNum = 1; std::getline(inStream, line); lineNum++) {
+		if (line.empty() || line[0] == '#' || line == "\r")
+			continue;
+
+		values.clear();
+		std::stringstream lineStream = std::stringstream(line);
+		std::string valueStr;
+		while (std::getline(lineStream, valueStr, ','))
+			values.push_back(std::stof(valueStr));
+
+		int expectedValues = CSV_FRAME_VALUES + CSV_CAR_VALUES * numCars;
+		if (values.size() != expectedValues)
+			RG_ERR_CLOSE(inPath << ":" << lineNum << ": Expected " << expectedValues << " values, got " << values.size());
+
+		const float* in = values.data();
+		auto fnReadVec = [&](float* out) {
+			for (int i = 0; i < 3; i++)
+				out[i] = *(in++);
+		};
+
+		frame = {};
+		frame.flags = *(in++) ? RFF_SEQUENCE_START : 0;
+		fnReadVec(frame.ballPos);
+		fnReadVec(frame.ballVel);
+		fnReadVec(frame.ballAngVel);
+		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++)
+			if (*(in++))
+				frame.boostPads[i / 32] |= 1u << (i % 32);
+
+		for (int i = 0; i < numCars; i++) {
+			ReplayCar& car = cars[i];
+			car = {};
+			car.team = *(in++);
+			fnReadVec(car.pos);
+
+			float yaw = *(in++), pitch = *(in++), roll = *(in++);
+			RotMat rotMat = Angle(yaw, pitch, roll).ToRotMat();
+			memcpy(car.forward, &rotMat.forward, sizeof(car.forward));
+			memcpy(car.right, &rotMat.right, sizeof(car.right));
+			memcpy(car.up, &rotMat.up, sizeof(car.up));
+
+			fnReadVec(car.vel);
+			fnReadVec(car.angVel);
+			car.boost = *(in++);
+
+			constexpr ReplayCarFlags FLAG_ORDER[] = {
+				RCF_ON_GROUND, RCF_HAS_JUMPED, RCF_HAS_DOUBLE_JUMPED, RCF_HAS_FLIPPED,
+				RCF_HAS_JUMP, RCF_HAS_FLIP, RCF_DEMOED, RCF_BALL_TOUCHED
+			};
+			for (ReplayCarFlags flag : FLAG_ORDER)
+				if (*(in++))
+					car.flags |= flag;
+
+			for (int j = 0; j < Action::ELEM_AMOUNT; j++)
+				car.action[j] = *(in++);
+		}
+
+		writer.WriteRawFrame(frameBytes.data());
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::filesystem::path outPath;
+	int numCars = 0, tickSkip = 8, numThreads = std::thread::hardware_concurrency();
+	std::vector<std::filesystem::path> inPaths;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--out" && hasValue) {
+			outPath = argv[++i];
+		} else if (arg == "--cars" && hasValue) {
+			numCars = std::stoi(argv[++i]);
+		} else if (arg == "--tick-skip" && hasValue) {
+			tickSkip = std::stoi(argv[++i]);
+		} else if (arg == "--threads" && hasValue) {
+			numThreads = std::stoi(argv[++i]);
+		} else if (arg.rfind("--", 0) != 0) {
+			inPaths.push_back(arg);
+		} else {
+			RG_LOG("Unknown or incomplete argument: " << arg);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (outPath.empty() || numCars <= 0 || inPaths.empty()) {
+		RG_LOG("Usage: RLGymPPO_CPP_ReplayConv --out <file> --cars <amount> [--tick-skip <ticks>] [--threads <amount>] <input csv>...");
+		return EXIT_FAILURE;
+	}
+
+	// Each input is converted to its own part file, so threads never wait on each other
+	std::vector<std::filesystem::path> partPaths;
+	for (int i = 0; i < inPaths.size(); i++)
+		partPaths.push_back(outPath.string() + ".part" + std::to_string(i));
+
+	std::atomic<int> nextInput = 0;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < RS_CLAMP(numThreads, 1, (int)inPaths.size()); i++) {
+		threads.push_back(std::thread([&]() {
+			for (int input = nextInput++; input < inPaths.size(); input = nextInput++) {
+				ConvertFile(inPaths[input], partPaths[input], numCars, tickSkip);
+				RG_LOG("Converted " << inPaths[input]);
+			}
+		}));
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	// Appending the parts only has to skip their headers, as every part has the same car count
+	uint64_t totalFrames = 0;
+	{
+		ReplayWriter writer = ReplayWriter(outPath, numCars, tickSkip);
+		std::vector<byte> frameBytes = std::vector<byte>(GetReplayFrameSize(numCars));
+		for (auto& partPath : partPaths) {
+			std::ifstream partStream = std::ifstream(partPath, std::ios::binary);
+			partStream.seekg(sizeof(ReplayFileHeader));
+			while (partStream.read((char*)frameBytes.data(), frameBytes.size()))
+				writer.WriteRawFrame(frameBytes.data());
+			partStream.close();
+			std::filesystem::remove(partPath);
+		}
+		totalFrames = writer.numFramesWritten;
+	}
+
+	RG_LOG("Wrote " << totalFrames << " frames from " << inPaths.size() << " file(s) to " << outPath);
+	return 0;
+}
@@ -0,0 +1,407 @@
+#include <RLGymSim_CPP/Framework.h>
+#include <Sim/btVehicleRL/BatchedRaycast.h>
+#include <Sim/MeshTriangleGrid/MeshTriangleGrid.h>
+#include <bullet3-3.24/LinearMath/btAabbUtil2.h>
+
+#include <random>
+#include <map>
+#include <array>
+
+using namespace RocketSim;
+
+// Checks RocketSim's optimized collision paths against the plain Bullet paths they replace
+//
+// Usage: RLGymPPO_CPP_SimCheck [--meshes <collision meshes folder>] [--poses <amount>] [--episodes <amount>] [--seed <seed>]
+// A tenth as many random AABB queries as poses are checked for the triangle grids
+// Each episode steps 4 cars for 300 ticks in an arena with batched suspension raycasts and in one without, comparing them every tick
+//
+// Without a meshes folder, a synthetic bumpy arena mesh is used, so this can run anywhere (it is also a CTest)
+// Exits with a failure if any result differs
+
+// Square grid of bumpy terrain, in the same format as the arena collision mesh files
+FileData MakeSyntheticMesh(int seed) {
+	constexpr int GRID_SIZE = 120;
+	constexpr float HALF_EXTENT = 5000, BUMP_HEIGHT = 30;
+
+	std::mt19937 rng = std::mt19937(seed);
+	std::uniform_real_distribution<float> heightDist = std::uniform_real_distribution<float>(-BUMP_HEIGHT, BUMP_HEIGHT);
+
+	std::vector<float> verts;
+	for (int y = 0; y <= GRID_SIZE; y++) {
+		for (int x = 0; x <= GRID_SIZE; x++) {
+			verts.push_back(-HALF_EXTENT + 2 * HALF_EXTENT * x / GRID_SIZE);
+			verts.push_back(-HALF_EXTENT + 2 * HALF_EXTENT * y / GRID_SIZE);
+			verts.push_back(heightDist(rng));
+		}
+	}
+
+	std::vector<int32_t> tris;
+	for (int y = 0; y < GRID_SIZE; y++) {
+		for (int x = 0; x < GRID_SIZE; x++) {
+			int32_t a = y * (GRID_SIZE + 1) + x, b = a + 1, c = a + GRID_SIZE + 1, d = c + 1;
+			tris.insert(tris.end(), { a, b, c, b, d, c });
+		}
+	}
+
+	FileData result;
+	auto fnWrite = [&](const void* data, size_t size) {
+		result.insert(result.end(), (const byte*)data, (const byte*)data + size);
+	};
+
+	int32_t numTris = tris.size() / 3, numVerts = verts.size() / 3;
+	fnWrite(&numTris, sizeof(numTris));
+	fnWrite(&numVerts, sizeof(numVerts));
+	fnWrite(tris.data(), tris.size() * sizeof(int32_t));
+	fnWrite(verts.data(), verts.size() * sizeof(float));
+	return result;
+}
+
+// Bounds of all soccar collision meshes, in Bullet units
+void GetArenaMeshBounds(btVector3& minOut, btVector3& maxOut) {
+	minOut = btVector3(FLT_MAX, FLT_MAX, FLT_MAX);
+	maxOut = -minOut;
+	for (auto shape : GetArenaCollisionShapes(GameMode::SOCCAR)) {
+		btVector3 shapeMin, shapeMax;
+		shape->getAabb(btTransform::getIdentity(), shapeMin, shapeMax);
+		minOut.setMin(shapeMin);
+		maxOut.setMax(shapeMax);
+	}
+}
+
+// Casts the suspension rays of cars at random poses, with CastRaysBatched() and with each car's btDefaultVehicleRaycaster
+// Returns the amount of rays that gave a different object, hit point, normal, or distance
+int CheckSuspensionRaycasts(int numPoses, std::mt19937& rng) {
+	Arena* arena = Arena::Create(GameMode::SOCCAR);
+
+	// The ball and the other cars are dynamic objects the rays can also hit
+	std::vector<Car*> cars;
+	for (int i = 0; i < 4; i++)
+		cars.push_back(arena->AddCar(i % 2 ? Team::ORANGE : Team::BLUE));
+
+	btVector3 meshMin, meshMax;
+	GetArenaMeshBounds(meshMin, meshMax);
+
+	// Keep poses inside the arena, and close enough to the floor for many of the rays to hit it
+	Vec poseMin = Vec(meshMin.x() * 0.9f, meshMin.y() * 0.9f, meshMin.z()) * BT_TO_UU;
+	Vec poseMax = Vec(meshMax.x() * 0.9f, meshMax.y() * 0.9f, meshMin.z()) * BT_TO_UU + Vec(0, 0, 120);
+	std::uniform_real_distribution<float> unitDist = std::uniform_real_distribution<float>(0, 1);
+	auto fnRandPos = [&]() {
+		return poseMin + (poseMax - poseMin) * Vec(unitDist(rng), unitDist(rng), unitDist(rng));
+	};
+
+	// Mostly upright, like cars driving around, but sometimes at any angle
+	auto fnRandRot = [&]() {
+		if (unitDist(rng) < 0.7f) {
+			return Angle((unitDist(rng) * 2 - 1) * M_PI, (unitDist(rng) * 2 - 1) * 0.3f, (unitDist(rng) * 2 - 1) * 0.3f).ToRotMat();
+		} else {
+			return Angle((unitDist(rng) * 2 - 1) * M_PI, (unitDist(rng) * 2 - 1) * M_PI / 2, (unitDist(rng) * 2 - 1) * M_PI).ToRotMat();
+		}
+	};
+
+	int numMismatches = 0, numHits = 0, numRays = 0;
+	for (int pose = 0; pose < numPoses; pose++) {
+		// The tested car might be resting right on another one, or on the ball
+		Vec basePos = fnRandPos();
+		for (Car* car : cars) {
+			CarState state = {};
+			state.pos = basePos + Vec(unitDist(rng) - 0.5f, unitDist(rng) - 0.5f, unitDist(rng) * 0.5f) * 300;
+			state.rotMat = fnRandRot();
+			car->SetState(state);
+		}
+
+		BallState ballState = {};
+		ballState.pos = basePos + Vec(unitDist(rng) - 0.5f, unitDist(rng) - 0.5f, 0) * 400;
+		arena->ball->SetState(ballState);
+
+		// Broadphase bounds have to be updated for the new poses, like at the start of a tick
+		arena->_bulletWorld.updateAabbs();
+
+		Car* car = cars[pose % cars.size()];
+		btVehicleRL& vehicle = car->_bulletVehicle;
+
+		btVector3 sources[4], targets[4];
+		for (int i = 0; i < 4; i++)
+			vehicle.prepareRay(vehicle.m_wheelInfo[i], sources[i], targets[i]);
+
+		btCollisionObject* batchedObjects[4];
+		btVehicleRaycaster::btVehicleRaycasterResult batchedResults[4];
+		CastRaysBatched(&arena->_bulletWorld, sources, targets, 4, &car->_rigidBody, batchedObjects, batchedResults);
+
+		for (int i = 0; i < 4; i++) {
+			btVehicleRaycaster::btVehicleRaycasterResult result;
+			auto object = (btCollisionObject*)car->_bulletVehicleRaycaster.castRay(sources[i], targets[i], &car->_rigidBody, result);
+
+			numRays++;
+			if (object)
+				numHits++;
+
+			auto& batchedResult = batchedResults[i];
+			bool matches = (object == batchedObjects[i]);
+			if (matches && object) {
+				matches =
+					result.m_distFraction == batchedResult.m_distFraction &&
+					result.m_hitPointInWorld == batchedResult.m_hitPointInWorld &&
+					result.m_hitNormalInWorld == batchedResult.m_hitNormalInWorld;
+			}
+
+			if (!matches) {
+				if (numMismatches < 10) {
+					RG_LOG(
+						" > Mismatch on ray " << numRays << ": fraction " << result.m_distFraction << " vs " << batchedResult.m_distFraction <<
+						", normal " << Vec(result.m_hitNormalInWorld) << " vs " << Vec(batchedResult.m_hitNormalInWorld)
+					);
+				}
+				numMismatches++;
+			}
+		}
+	}
+
+	RG_LOG("Suspension raycasts: " << numRays << " rays, " << numHits << " hits, " << numMismatches << " mismatches");
+
+	delete arena;
+	return numMismatches;
+}
+
+// Largest difference between the physics states of two cars
+float GetCarStateDiff(const CarState& a, const CarState& b) {
+	float diff = 0;
+	diff = RS_MAX(diff, a.pos.Dist(b.pos));
+	diff = RS_MAX(diff, a.vel.Dist(b.vel));
+	diff = RS_MAX(diff, a.angVel.Dist(b.angVel));
+	diff = RS_MAX(diff, a.rotMat.forward.Dist(b.rotMat.forward));
+	diff = RS_MAX(diff, a.rotMat.right.Dist(b.rotMat.right));
+	diff = RS_MAX(diff, a.rotMat.up.Dist(b.rotMat.up));
+	return diff;
+}
+
+// Drives cars along scripted trajectories in two identical arenas, one casting suspension rays with CastRaysBatched()
+//	and the other one wheel at a time with btDefaultVehicleRaycaster, and compares the car states every tick
+// Positions and velocities are in UU and UU/s, so the tolerance is far below anything visible in a replay
+// Returns the amount of car ticks whose states differ by more than the tolerance, or whose wheel contacts differ
+int CheckSuspensionTrajectories(int numEpisodes, std::mt19937& rng) {
+	constexpr int NUM_CARS = 4, EPISODE_TICKS = 300, CONTROLS_INTERVAL = 8;
+	constexpr float TOLERANCE = 1e-3f;
+
+	Arena* arenas[2];
+	for (int i = 0; i < 2; i++) {
+		arenas[i] = Arena::Create(GameMode::SOCCAR);
+		for (int j = 0; j < NUM_CARS; j++) {
+			Car* car = arenas[i]->AddCar(j % 2 ? Team::ORANGE : Team::BLUE);
+			car->_bulletVehicle.m_batchedRaycast = (i == 0);
+		}
+	}
+
+	btVector3 meshMin, meshMax;
+	GetArenaMeshBounds(meshMin, meshMax);
+
+	// Start near the middle of the arena, so cars bump into each other and the ball, and rarely leave the floor for long
+	// Cars are dropped from a bit above the lowest floor point, which clears the synthetic mesh's bumps
+	Vec startMin = Vec(meshMin.x() * 0.3f, meshMin.y() * 0.3f, meshMin.z()) * BT_TO_UU + Vec(0, 0, 80);
+	Vec startMax = Vec(meshMax.x() * 0.3f, meshMax.y() * 0.3f, meshMin.z()) * BT_TO_UU + Vec(0, 0, 140);
+	std::uniform_real_distribution<float> unitDist = std::uniform_real_distribution<float>(0, 1);
+	auto fnRandPos = [&]() {
+		return startMin + (startMax - startMin) * Vec(unitDist(rng), unitDist(rng), unitDist(rng));
+	};
+	auto fnRandSigned = [&]() {
+		return unitDist(rng) * 2 - 1;
+	};
+
+	int numMismatches = 0, numCarTicks = 0, numWheelContacts = 0;
+	float maxDiff = 0;
+	for (int episode = 0; episode < numEpisodes; episode++) {
+		for (int i = 0; i < NUM_CARS; i++) {
+			CarState state = {};
+			state.pos = fnRandPos();
+			state.rotMat = Angle(fnRandSigned() * M_PI, fnRandSigned() * 0.2f, fnRandSigned() * 0.2f).ToRotMat();
+			state.vel = Vec(fnRandSigned(), fnRandSigned(), 0) * 1500;
+			state.boost = 100;
+			for (Arena* arena : arenas)
+				arena->GetCars()[i]->SetState(state);
+		}
+
+		BallState ballState = {};
+		ballState.pos = fnRandPos() + Vec(0, 0, 100);
+		ballState.vel = Vec(fnRandSigned(), fnRandSigned(), 0) * 1000;
+		for (Arena* arena : arenas)
+			arena->ball->SetState(ballState);
+
+		// Log at most one mismatch per episode, as the trajectories diverge after the first one
+		bool episodeLogged = false;
+		for (int tick = 0; tick < EPISODE_TICKS; tick++) {
+			if (tick % CONTROLS_INTERVAL == 0) {
+				for (int i = 0; i < NUM_CARS; i++) {
+					CarControls controls = {};
+					controls.throttle = unitDist(rng) < 0.8f ? 1 : -1;
+					controls.steer = fnRandSigned();
+					controls.pitch = fnRandSigned();
+					controls.yaw = fnRandSigned();
+					controls.roll = fnRandSigned();
+					controls.boost = unitDist(rng) < 0.3f;
+					controls.jump = unitDist(rng) < 0.05f;
+					controls.handbrake = unitDist(rng) < 0.1f;
+					for (Arena* arena : arenas)
+						arena->GetCars()[i]->controls = controls;
+				}
+			}
+
+			for (Arena* arena : arenas)
+				arena->Step(1);
+
+			for (int i = 0; i < NUM_CARS; i++) {
+				CarState batchedState = arenas[0]->GetCars()[i]->GetState();
+				CarState perWheelState = arenas[1]->GetCars()[i]->GetState();
+
+				bool contactsMatch = true;
+				for (int j = 0; j < 4; j++) {
+					contactsMatch &= batchedState.wheelsWithContact[j] == perWheelState.wheelsWithContact[j];
+					numWheelContacts += batchedState.wheelsWithContact[j];
+				}
+
+				float diff = GetCarStateDiff(batchedState, perWheelState);
+				maxDiff = RS_MAX(maxDiff, diff);
+				numCarTicks++;
+
+				if (diff > TOLERANCE || !contactsMatch) {
+					if (!episodeLogged && numMismatches < 10) {
+						RG_LOG(
+							" > Mismatch in episode " << episode << " on tick " << tick << ", car " << i << ": state diff " << diff <<
+							", pos " << batchedState.pos << " vs " << perWheelState.pos
+						);
+						episodeLogged = true;
+					}
+					numMismatches++;
+				}
+			}
+		}
+	}
+
+	RG_LOG(
+		"Suspension trajectories: " << numEpisodes << " episodes, " << numCarTicks << " car ticks, " << numWheelContacts << " wheel contacts, " <<
+		"max state diff " << maxDiff << " (tolerance " << TOLERANCE << "), " << numMismatches << " mismatches"
+	);
+
+	for (Arena* arena : arenas)
+		delete arena;
+	return numMismatches;
+}
+
+// Triangles given to a btTriangleCallback, by (partId, triangleIndex)
+// Only keeps triangles whose own AABB overlaps the query AABB, since both the BVH and the grid can give extra ones
+struct CollectTrianglesCallback : public btTriangleCallback {
+	btVector3 queryMin, queryMax;
+	std::map<std::pair<int, int>, std::array<btVector3, 3>> triangles;
+	int numDuplicates = 0;
+
+	CollectTrianglesCallback(btVector3 queryMin, btVector3 queryMax) : queryMin(queryMin), queryMax(queryMax) {}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
+		btVector3 triMin = triangle[0], triMax = triangle[0];
+		for (int i = 1; i < 3; i++) {
+			triMin.setMin(triangle[i]);
+			triMax.setMax(triangle[i]);
+		}
+
+		if (!TestAabbAgainstAabb2(triMin, triMax, queryMin, queryMax))
+			return;
+
+		bool inserted = triangles.insert({ { partId, triangleIndex }, { triangle[0], triangle[1], triangle[2] } }).second;
+		if (!inserted)
+			numDuplicates++;
+	}
+};
+
+// Queries random AABBs (from car-sized to much larger) in each arena mesh, with MeshTriangleGrid and with the mesh's BVH
+// Returns the amount of queries that gave a different set of overlapping triangles, or reported one more than once
+int CheckTriangleGrids(int numQueries, std::mt19937& rng) {
+	std::uniform_real_distribution<float> unitDist = std::uniform_real_distribution<float>(0, 1);
+
+	int numMismatches = 0, numQueriesRan = 0;
+	size_t numTrianglesFound = 0;
+	for (auto shape : GetArenaCollisionShapes(GameMode::SOCCAR)) {
+		const MeshTriangleGrid* triGrid = MeshTriangleGrid::Get(shape);
+		if (!triGrid) {
+			RG_LOG(" > No triangle grid on a mesh (RS_NO_MESHTRIGRID is defined?), skipping it");
+			continue;
+		}
+
+		btVector3 meshMin, meshMax;
+		shape->getAabb(btTransform::getIdentity(), meshMin, meshMax);
+		btVector3 meshExtent = meshMax - meshMin;
+
+		int numShapeQueries = numQueries / GetArenaCollisionShapes(GameMode::SOCCAR).size() + 1;
+		for (int query = 0; query < numShapeQueries; query++) {
+			// Queries can stick out of the mesh
+			btVector3 center = meshMin + meshExtent * btVector3(unitDist(rng), unitDist(rng), unitDist(rng)) * 1.2f - meshExtent * 0.1f;
+			float sizeScale = powf(10, unitDist(rng) * 2); // 1x to 100x
+			btVector3 halfSize = btVector3(unitDist(rng), unitDist(rng), unitDist(rng)) * sizeScale * 50 * UU_TO_BT;
+			btVector3 queryMin = center - halfSize, queryMax = center + halfSize;
+
+			CollectTrianglesCallback gridTris = CollectTrianglesCallback(queryMin, queryMax);
+			triGrid->ProcessTrianglesInAABB(&gridTris, queryMin, queryMax);
+
+			CollectTrianglesCallback bvhTris = CollectTrianglesCallback(queryMin, queryMax);
+			shape->processAllTriangles(&bvhTris, queryMin, queryMax);
+
+			numQueriesRan++;
+			numTrianglesFound += bvhTris.triangles.size();
+
+			if (gridTris.triangles != bvhTris.triangles || gridTris.numDuplicates > 0) {
+				if (numMismatches < 10) {
+					RG_LOG(
+						" > Mismatch on query " << numQueriesRan << ": " << gridTris.triangles.size() << " grid triangles (" << gridTris.numDuplicates << " duplicates) vs " <<
+						bvhTris.triangles.size() << " BVH triangles"
+					);
+				}
+				numMismatches++;
+			}
+		}
+	}
+
+	RG_LOG("Triangle grids: " << numQueriesRan << " queries, " << numTrianglesFound << " triangles, " << numMismatches << " mismatches");
+	return numMismatches;
+}
+
+int main(int argc, char* argv[]) {
+	std::filesystem::path meshesPath;
+	int numPoses = 50 * 1000;
+	int numEpisodes = 100;
+	int seed = 123;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--meshes" && hasValue) {
+			meshesPath = argv[++i];
+		} else if (arg == "--poses" && hasValue) {
+			numPoses = std::stoi(argv[++i]);
+		} else if (arg == "--episodes" && hasValue) {
+			numEpisodes = std::stoi(argv[++i]);
+		} else if (arg == "--seed" && hasValue) {
+			seed = std::stoi(argv[++i]);
+		} else {
+			RG_LOG("Usage: RLGymPPO_CPP_SimCheck [--meshes <collision meshes folder>] [--poses <amount>] [--episodes <amount>] [--seed <seed>]");
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (meshesPath.empty()) {
+		RocketSim::InitFromMem({ { GameMode::SOCCAR, { MakeSyntheticMesh(seed) } } }, true);
+	} else {
+		RocketSim::Init(meshesPath, true);
+	}
+
+	std::mt19937 rng = std::mt19937(seed);
+	int numMismatches = 0;
+	numMismatches += CheckSuspensionRaycasts(numPoses, rng);
+	numMismatches += CheckSuspensionTrajectories(numEpisodes, rng);
+	numMismatches += CheckTriangleGrids(numPoses / 10, rng);
+
+	if (numMismatches > 0) {
+		RG_LOG("FAILED: " << numMismatches << " mismatches");
+		return EXIT_FAILURE;
+	}
+
+	RG_LOG("All checks passed");
+	return 0;
+}